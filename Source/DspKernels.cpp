@@ -0,0 +1,337 @@
+/*
+  ==============================================================================
+
+    DspKernels.cpp
+
+  ==============================================================================
+*/
+
+#include "DspKernels.h"
+#include "FastMath.h"
+
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+ #define SUB808_MULTI_ISA 1
+#else
+ #define SUB808_MULTI_ISA 0
+#endif
+
+namespace Sub808Dsp
+{
+namespace
+{
+    //==============================================================================
+    // Kernel bodies. These are force-inlined into the per-ISA wrappers further
+    // down, so each wrapper gets its own copy vectorised for its target.
+
+    forcedinline void oscillatorBody (OscillatorLanes& o, const float* freqHz, float invSampleRate,
+                                      float* left, float* right, int numSamples) noexcept
+    {
+        constexpr int n = OscillatorLanes::numLanes;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float inc = freqHz[i] * invSampleRate;
+
+            alignas (64) float l[n];
+            alignas (64) float r[n];
+
+            for (int v = 0; v < n; ++v)
+            {
+                float p = o.phase[v] + inc * o.ratio[v];
+                p -= (float) (int) p; // increments are positive, so truncation == floor
+                o.phase[v] = p;
+
+                const float s = Sub808FastMath::sin2Pi (p);
+                l[v] = s * o.gainL[v];
+                r[v] = s * o.gainR[v];
+            }
+
+            // Pairwise reduction spelled out explicitly so it vectorises without
+            // needing -ffast-math to reassociate a running sum.
+            for (int w = n / 2; w > 0; w /= 2)
+                for (int v = 0; v < w; ++v)
+                {
+                    l[v] += l[v + w];
+                    r[v] += r[v + w];
+                }
+
+            left[i]  = l[0];
+            right[i] = r[0];
+        }
+    }
+
+    forcedinline void envelopeBody (float* data, const float* env, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] *= env[i];
+    }
+
+    forcedinline void envelopeSegmentBody (float* out, int numSamples, float asymptote, float& offset,
+                                           const float* coefPowers, float coefPowLanes, float coef) noexcept
+    {
+        constexpr int lanes = envelopeSegmentLanes;
+        float d = offset;
+        int i = 0;
+
+        // value[n] = asymptote + offset * coef^(n+1): a whole run of lanes
+        // comes from one offset and the power table, so the inner loop has no
+        // loop-carried dependency and vectorises.
+        for (; i + lanes <= numSamples; i += lanes)
+        {
+            for (int k = 0; k < lanes; ++k)
+                out[i + k] = asymptote + d * coefPowers[k];
+
+            d *= coefPowLanes;
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            d *= coef;
+            out[i] = asymptote + d;
+        }
+
+        offset = d;
+    }
+
+    forcedinline void kitBody (KitLanes& k, float* out, int numSamples) noexcept
+    {
+        constexpr int n = KitLanes::numLanes;
+
+        // Samples outer, lanes inner: each lane's recurrences are serial in
+        // time, but across lanes everything is independent, so the oscillator
+        // and tone loops vectorise over all slots at once.
+        for (int i = 0; i < numSamples; ++i)
+        {
+            alignas (64) float s[n];
+
+            for (int v = 0; v < n; ++v)
+            {
+                float p = k.phase[v] + k.phaseInc[v];
+                p -= (float) (int) p;
+                k.phase[v] = p;
+
+                s[v] = Sub808FastMath::sin2Pi (p) * (k.envAsymptote[v] + k.envOffset[v]);
+                k.envOffset[v] *= k.envCoef[v];
+            }
+
+            // No per-lane select: a slot with drive off runs at
+            // KitLanes::transparentDriveK, so the loop stays one vector block.
+            for (int v = 0; v < n; ++v)
+                s[v] = Sub808FastMath::tanh (k.driveK[v] * s[v]) * k.driveNorm[v];
+
+            float* o = out + i * n;
+
+            for (int v = 0; v < n; ++v)
+            {
+                const float z = k.toneFeedback[v] * k.toneZ[v] + k.toneInputGain[v] * s[v];
+                k.toneZ[v] = z;
+                o[v] = z;
+            }
+        }
+    }
+
+    forcedinline void levelDetectBody (const float* data, int numSamples, float& peak, float& sumSquares) noexcept
+    {
+        constexpr int n = 16;
+
+        // Per-lane running max / sum, reduced at the end, so both vectorise
+        // without -ffast-math having to reorder the sum.
+        alignas (64) float pk[n] {};
+        alignas (64) float sq[n] {};
+        int i = 0;
+
+        for (; i + n <= numSamples; i += n)
+            for (int v = 0; v < n; ++v)
+            {
+                const float x = data[i + v];
+                const float a = std::abs (x);
+                pk[v] = a > pk[v] ? a : pk[v];
+                sq[v] += x * x;
+            }
+
+        for (int v = 0; i < numSamples; ++i, ++v)
+        {
+            const float x = data[i];
+            const float a = std::abs (x);
+            pk[v] = a > pk[v] ? a : pk[v];
+            sq[v] += x * x;
+        }
+
+        for (int w = n / 2; w > 0; w /= 2)
+            for (int v = 0; v < w; ++v)
+            {
+                pk[v] = pk[v + w] > pk[v] ? pk[v + w] : pk[v];
+                sq[v] += sq[v + w];
+            }
+
+        peak = pk[0];
+        sumSquares = sq[0];
+    }
+
+    forcedinline void driveBody (float* data, int numSamples, float k, float norm) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = Sub808FastMath::tanh (k * data[i]) * norm;
+    }
+
+    forcedinline void toneFilterBody (float* data, int numSamples, float& z,
+                                      float feedback, float inputGain) noexcept
+    {
+        // The recurrence itself is serial; the input scaling ahead of it is not.
+        for (int i = 0; i < numSamples; ++i)
+            data[i] *= inputGain;
+
+        float y = z;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            y = feedback * y + data[i];
+            data[i] = y;
+        }
+
+        z = y;
+    }
+
+    forcedinline void fanOutBody (float* dest, const float* src, float gain, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = src[i] * gain;
+    }
+
+    //==============================================================================
+   #define SUB808_DEFINE_KERNEL_SET(ns, targetAttribute)                                               \
+    namespace ns                                                                                        \
+    {                                                                                                   \
+        targetAttribute void oscillator (OscillatorLanes& o, const float* f, float inv,                 \
+                                         float* l, float* r, int n)   { oscillatorBody (o, f, inv, l, r, n); } \
+        targetAttribute void envelope (float* d, const float* e, int n) { envelopeBody (d, e, n); }     \
+        targetAttribute void envelopeSegment (float* o, int n, float a, float& d, const float* p,       \
+                                              float pl, float c) { envelopeSegmentBody (o, n, a, d, p, pl, c); } \
+        targetAttribute void kit (KitLanes& k, float* o, int n)         { kitBody (k, o, n); }           \
+        targetAttribute void levelDetect (const float* d, int n, float& p, float& s) { levelDetectBody (d, n, p, s); } \
+        targetAttribute void drive (float* d, int n, float k, float g)  { driveBody (d, n, k, g); }      \
+        targetAttribute void toneFilter (float* d, int n, float& z, float fb, float g) { toneFilterBody (d, n, z, fb, g); } \
+        targetAttribute void fanOut (float* d, const float* s, float g, int n) { fanOutBody (d, s, g, n); } \
+    }
+
+    SUB808_DEFINE_KERNEL_SET (generic, )
+
+   #if SUB808_MULTI_ISA
+    SUB808_DEFINE_KERNEL_SET (sse2,   __attribute__ ((target ("sse2"))))
+    SUB808_DEFINE_KERNEL_SET (avx2,   __attribute__ ((target ("avx2,fma"))))
+    SUB808_DEFINE_KERNEL_SET (avx512, __attribute__ ((target ("avx512f,avx2,fma"))))
+   #endif
+
+   #undef SUB808_DEFINE_KERNEL_SET
+
+   #define SUB808_KERNEL_TABLE(ns, isa) \
+    { isa, ns::oscillator, ns::envelope, ns::envelopeSegment, ns::kit, ns::levelDetect, ns::drive, ns::toneFilter, ns::fanOut }
+
+    const KernelTable kernelTables[] =
+    {
+        SUB808_KERNEL_TABLE (generic, Isa::generic),
+       #if SUB808_MULTI_ISA
+        SUB808_KERNEL_TABLE (sse2,    Isa::sse2),
+        SUB808_KERNEL_TABLE (avx2,    Isa::avx2),
+        SUB808_KERNEL_TABLE (avx512,  Isa::avx512),
+       #endif
+    };
+
+   #undef SUB808_KERNEL_TABLE
+
+    const KernelTable& tableFor (Isa isa) noexcept
+    {
+        for (auto& t : kernelTables)
+            if (t.isa == isa)
+                return t;
+
+        return kernelTables[0];
+    }
+
+    Isa detectIsa() noexcept
+    {
+       #if SUB808_MULTI_ISA
+        if (juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+            return Isa::avx512;
+
+        if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+            return Isa::avx2;
+
+        if (juce::SystemStats::hasSSE2())
+            return Isa::sse2;
+       #endif
+
+        return Isa::generic;
+    }
+
+    Isa clampToDetected (Isa requested) noexcept
+    {
+        return (int) requested <= (int) getDetectedIsa() ? requested : getDetectedIsa();
+    }
+
+    Isa isaFromEnvironment() noexcept
+    {
+        const auto name = juce::SystemStats::getEnvironmentVariable ("SUB808_ISA", {}).trim().toLowerCase();
+
+        for (auto isa : { Isa::generic, Isa::sse2, Isa::avx2, Isa::avx512 })
+            if (name == getIsaName (isa))
+                return clampToDetected (isa);
+
+        return getDetectedIsa();
+    }
+
+    // Constant-initialised, so getKernels() never runs any set-up code.
+    // initialise() swaps in the real choice.
+    std::atomic<const KernelTable*> activeTable { kernelTables };
+}
+
+//==============================================================================
+void initialise() noexcept
+{
+    // Reading SUB808_ISA allocates, so it happens here, once, rather than
+    // lazily on whichever thread first asks for the kernels.
+    static const bool initialised = []
+    {
+        activeTable.store (&tableFor (isaFromEnvironment()), std::memory_order_release);
+        return true;
+    }();
+
+    juce::ignoreUnused (initialised);
+}
+
+const KernelTable& getKernels() noexcept
+{
+    return *activeTable.load (std::memory_order_acquire);
+}
+
+Isa getDetectedIsa() noexcept
+{
+    static const Isa detected = detectIsa();
+    return detected;
+}
+
+void setIsaOverride (Isa isa) noexcept
+{
+    initialise(); // so a later initialise() can't replace the override
+    activeTable.store (&tableFor (clampToDetected (isa)), std::memory_order_release);
+}
+
+void clearIsaOverride() noexcept
+{
+    initialise();
+    activeTable.store (&tableFor (getDetectedIsa()), std::memory_order_release);
+}
+
+const char* getIsaName (Isa isa) noexcept
+{
+    switch (isa)
+    {
+        case Isa::sse2:    return "sse2";
+        case Isa::avx2:    return "avx2";
+        case Isa::avx512:  return "avx512";
+        case Isa::generic: break;
+    }
+
+    return "generic";
+}
+}
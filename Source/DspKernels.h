@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    DspKernels.h
+    Hot DSP loops, built once per instruction set and picked at start-up.
+
+    The kernels themselves are plain C++ loops written so the compiler can
+    vectorise them. DspKernels.cpp compiles that same code several times with
+    different target ISAs (SSE2 / AVX2 / AVX-512 on x86 with GCC or Clang)
+    and getKernels() hands out the widest variant the host CPU supports, so
+    one binary runs everywhere without leaving vector width on the table.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Sub808Dsp
+{
+    /** Per-lane oscillator state for the unison stack. */
+    struct OscillatorLanes
+    {
+        static constexpr int numLanes = 16; // a whole AVX-512 register
+
+        alignas (64) float phase[numLanes] {};
+        alignas (64) float ratio[numLanes] {};
+        alignas (64) float gainL[numLanes] {};
+        alignas (64) float gainR[numLanes] {};
+    };
+
+    /** Drum-kit slots, one lane each, stored structure-of-arrays so every
+        slot renders in the same pass. */
+    struct KitLanes
+    {
+        static constexpr int numLanes = 16;
+
+        /** Drive pre-gain for a lane with drive off. tanh (k * x) / tanh (k)
+            equals x to float precision at this k, so every lane can go
+            through the same tanh with no per-lane select. */
+        static constexpr float transparentDriveK = 1.0e-4f;
+
+        alignas (64) float phase[numLanes] {};
+        alignas (64) float phaseInc[numLanes] {};      // cycles per sample
+        alignas (64) float envAsymptote[numLanes] {};  // envelope = asymptote + offset, offset *= coef
+        alignas (64) float envOffset[numLanes] {};
+        alignas (64) float envCoef[numLanes] {};
+        alignas (64) float driveK[numLanes] {};        // transparentDriveK = drive off
+        alignas (64) float driveNorm[numLanes] {};
+        alignas (64) float toneFeedback[numLanes] {};
+        alignas (64) float toneInputGain[numLanes] {};
+        alignas (64) float toneZ[numLanes] {};
+    };
+
+    /** Run length the envelopeSegment kernel steps by. */
+    static constexpr int envelopeSegmentLanes = 16;
+
+    enum class Isa
+    {
+        generic, // whatever the compiler's baseline target is
+        sse2,
+        avx2,
+        avx512
+    };
+
+    struct KernelTable
+    {
+        Isa isa;
+
+        /** Advances every oscillator lane by numSamples, one fundamental per sample. */
+        void (*oscillator) (OscillatorLanes& lanes, const float* freqHz, float invSampleRate,
+                            float* left, float* right, int numSamples);
+
+        /** data *= env, sample by sample. */
+        void (*envelope)   (float* data, const float* env, int numSamples);
+
+        /** Fills out with asymptote + offset * coef^(n+1), n = 0..numSamples-1, and
+            leaves offset at its last value. coefPowers holds coef^1..coef^lanes
+            and coefPowLanes is coef^lanes (see envelopeSegmentLanes). */
+        void (*envelopeSegment) (float* out, int numSamples, float asymptote, float& offset,
+                                 const float* coefPowers, float coefPowLanes, float coef);
+
+        /** Renders numSamples of every kit lane into out, interleaved as
+            out[sample * KitLanes::numLanes + lane]. */
+        void (*kit)        (KitLanes& lanes, float* out, int numSamples);
+
+        /** Largest |x| and sum of x^2 over numSamples, for the sidechain detector. */
+        void (*levelDetect) (const float* data, int numSamples, float& peak, float& sumSquares);
+
+        /** data = tanh (k * data) * norm */
+        void (*drive)      (float* data, int numSamples, float k, float norm);
+
+        /** One-pole z = feedback * z + inputGain * x (the color tilt folded into the tone LPF). */
+        void (*toneFilter) (float* data, int numSamples, float& z, float feedback, float inputGain);
+
+        /** dest = src * gain */
+        void (*fanOut)     (float* dest, const float* src, float gain, int numSamples);
+    };
+
+    /** Picks the kernel set for this CPU (and SUB808_ISA, see below). Only
+        the first call does anything; call it from prepareToPlay, since it
+        reads the environment. Until then getKernels() returns the generic set. */
+    void initialise() noexcept;
+
+    /** The kernel set in use. Cheap enough to call once per block, and safe
+        on the audio thread. */
+    const KernelTable& getKernels() noexcept;
+
+    /** The widest ISA this CPU supports that was compiled in. */
+    Isa getDetectedIsa() noexcept;
+
+    /** Forces a narrower kernel set, e.g. to compare ISAs or reproduce a bug
+        from another machine. Requests wider than the CPU supports are clamped.
+        The SUB808_ISA environment variable (generic, sse2, avx2, avx512) does
+        the same at start-up. */
+    void setIsaOverride (Isa isa) noexcept;
+    void clearIsaOverride() noexcept;
+
+    const char* getIsaName (Isa isa) noexcept;
+}
@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    EngineCommands.h
+    Wait-free message thread -> audio thread command queue.
+
+    Non-parameter actions (panic, reset, swapping in a freshly built resource)
+    are posted from the message thread and drained at the start of
+    processBlock. Resources that get replaced are handed back through a second
+    FIFO and destroyed by collectGarbage() on the message thread, so the audio
+    thread never frees memory or takes a lock.
+
+    Both FIFOs are single-producer / single-consumer: only the message thread
+    may post or collect garbage, only the audio thread may drain.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Base for any heap object handed to the audio engine through the queue. */
+struct Sub808EngineResource
+{
+    virtual ~Sub808EngineResource() = default;
+};
+
+struct Sub808EngineCommand
+{
+    enum class Type
+    {
+        panic,        // silence the voice immediately, keep everything else
+        resetState,   // back to the state right after prepareToPlay
+        swapResource  // *target = resource; the old one is sent back for deletion
+    };
+
+    Type type = Type::panic;
+    Sub808EngineResource** target = nullptr;
+    Sub808EngineResource* resource = nullptr;
+};
+
+//==============================================================================
+/** Fixed-capacity SPSC ring of trivially copyable items on top of juce::AbstractFifo. */
+template <typename Item, int capacity>
+class Sub808SpscQueue
+{
+public:
+    bool push (const Item& item) noexcept
+    {
+        if (fifo.getFreeSpace() == 0)
+            return false;
+
+        const auto scope = fifo.write (1);
+        items[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = item;
+        return true;
+    }
+
+    bool pop (Item& item) noexcept
+    {
+        if (fifo.getNumReady() == 0)
+            return false;
+
+        const auto scope = fifo.read (1);
+        item = items[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+        return true;
+    }
+
+    int getNumReady() const noexcept   { return fifo.getNumReady(); }
+    int getFreeSpace() const noexcept  { return fifo.getFreeSpace(); }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<Item, (size_t) capacity> items {};
+};
+
+//==============================================================================
+class Sub808CommandQueue
+{
+public:
+    static constexpr int capacity = 64;
+
+    Sub808CommandQueue() = default;
+
+    ~Sub808CommandQueue()
+    {
+        // Anything still in flight is owned by the queue at this point.
+        Sub808EngineCommand cmd;
+
+        while (commands.pop (cmd))
+            delete cmd.resource;
+
+        collectGarbage();
+    }
+
+    //==============================================================================
+    // Message thread
+
+    /** Queues a command without a resource. Returns false if the queue is full. */
+    bool post (Sub808EngineCommand::Type type) noexcept
+    {
+        jassert (type != Sub808EngineCommand::Type::swapResource);
+        return commands.push ({ type, nullptr, nullptr });
+    }
+
+    /** Asks the audio thread to install newResource into *target. The object
+        currently in *target comes back through collectGarbage(). If the queue
+        is full the new resource is destroyed here and false is returned. */
+    template <typename ResourceType>
+    bool swapResource (Sub808EngineResource*& target, std::unique_ptr<ResourceType> newResource)
+    {
+        // Every swap retires exactly one entry, and stays outstanding until
+        // collectGarbage() has taken that entry back, whether it is still
+        // queued, already applied, or sitting in the return FIFO. Capping the
+        // count at the return FIFO's size is what lets retire() never fail.
+        if (outstandingSwaps.load() >= maxOutstandingSwaps)
+            return false;
+
+        if (! commands.push ({ Sub808EngineCommand::Type::swapResource, &target, newResource.get() }))
+            return false;
+
+        ++outstandingSwaps;
+        newResource.release();
+        return true;
+    }
+
+    /** Deletes resources the audio thread has finished with. */
+    void collectGarbage()
+    {
+        Sub808EngineResource* old = nullptr;
+
+        while (retired.pop (old))
+        {
+            delete old;
+            --outstandingSwaps;
+        }
+    }
+
+    //==============================================================================
+    // Audio thread
+
+    /** Handles every pending command. Swaps are applied here; the handler is
+        called for the rest. */
+    template <typename Handler>
+    void drain (Handler&& handler) noexcept
+    {
+        Sub808EngineCommand cmd;
+
+        while (commands.pop (cmd))
+        {
+            if (cmd.type == Sub808EngineCommand::Type::swapResource)
+            {
+                // Retired even when null, so the swap is accounted for
+                retire (*cmd.target);
+                *cmd.target = cmd.resource;
+            }
+            else
+            {
+                handler (cmd);
+            }
+        }
+    }
+
+private:
+    // AbstractFifo keeps one slot free, so a FIFO of capacity holds capacity - 1
+    static constexpr int maxOutstandingSwaps = capacity - 1;
+
+    /** Hands a replaced object (or null) back to the message thread. */
+    void retire (Sub808EngineResource* old) noexcept
+    {
+        const bool queued = retired.push (old);
+        jassert (queued); // swapResource() caps the swaps in flight, so this can't fail
+        juce::ignoreUnused (queued);
+    }
+
+    Sub808SpscQueue<Sub808EngineCommand, capacity> commands;
+    Sub808SpscQueue<Sub808EngineResource*, capacity> retired;
+    std::atomic<int> outstandingSwaps { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Sub808CommandQueue)
+};
@@ -0,0 +1,315 @@
+/*
+  ==============================================================================
+
+    Envelope.h
+    Analog-style exponential attack / hold / decay / sustain / release.
+
+    Every moving stage is an RC-style curve
+        value[n] = asymptote + offset * coef^n
+    aimed slightly past its end level so it arrives in finite time. Because
+    the curve has a closed form, a stage's length is known the moment it
+    starts and whole runs of samples are generated by the envelopeSegment
+    kernel from a table of coef powers, instead of one call per sample.
+    Idle and sustain are plain fills.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+/** One RC-style segment, value[n] = asymptote + offset * coef^n for n = 0..length,
+    heading from `from` to `target`. It aims `ratio` past the target so it
+    arrives in finite time; `seconds` is the time a full-scale move takes. */
+struct Sub808EnvelopeCurve
+{
+    float asymptote = 0.0f, offset = 0.0f, coef = 0.0f;
+    int length = 0; // samples until the target is crossed, 0 if already there
+
+    static Sub808EnvelopeCurve make (float from, float target, float ratio,
+                                     float seconds, double sampleRate) noexcept
+    {
+        Sub808EnvelopeCurve c;
+
+        const double steps = juce::jmax (1.0, (double) seconds * sampleRate);
+        const double k     = std::exp (-std::log ((1.0 + ratio) / ratio) / steps);
+
+        c.asymptote = target + (target > from ? ratio : -ratio);
+        c.offset    = from - c.asymptote;
+        c.coef      = (float) k;
+
+        // Closed-form length: the n where the curve crosses the target
+        const double fraction = (double) (target - c.asymptote) / (double) c.offset;
+        c.length = (! juce::exactlyEqual (c.offset, 0.0f) && fraction > 0.0 && fraction < 1.0)
+                     ? (int) juce::jlimit (1.0, 1.0e9, std::ceil (std::log (fraction) / std::log (k)))
+                     : 0;
+        return c;
+    }
+};
+
+//==============================================================================
+class Sub808Envelope
+{
+public:
+    struct Parameters
+    {
+        float attack  = 0.005f; // seconds
+        float hold    = 0.0f;   // seconds at the peak before the decay starts
+        float decay   = 0.05f;
+        float sustain = 0.8f;   // level, relative to the note's peak
+        float release = 0.15f;
+
+        bool operator== (const Parameters& o) const noexcept
+        {
+            return juce::exactlyEqual (attack, o.attack) && juce::exactlyEqual (hold, o.hold)
+                && juce::exactlyEqual (decay, o.decay) && juce::exactlyEqual (sustain, o.sustain)
+                && juce::exactlyEqual (release, o.release);
+        }
+
+        bool operator!= (const Parameters& o) const noexcept { return ! operator== (o); }
+    };
+
+    void setSampleRate (double newSampleRate) noexcept
+    {
+        if (juce::exactlyEqual (newSampleRate, sampleRateHz))
+            return;
+
+        sampleRateHz = newSampleRate;
+        restartStage();
+    }
+
+    /** Cheap when nothing changed. The running stage is only re-timed (from
+        its current level) when a setting it depends on changed; the others
+        take effect when their stage starts. */
+    void setParameters (const Parameters& newParams) noexcept
+    {
+        if (newParams == params)
+            return;
+
+        const bool restart = affectsStage (newParams);
+        params = newParams;
+
+        if (restart)
+            restartStage();
+    }
+
+    /** Starts the attack from wherever the envelope currently is (no click on
+        retrigger), heading for peakLevel. */
+    void noteOn (float peakLevel = 1.0f) noexcept
+    {
+        peak = juce::jlimit (0.0f, 1.0f, peakLevel);
+        enterStage (Stage::attack);
+    }
+
+    void noteOff() noexcept
+    {
+        if (stage != Stage::idle)
+            enterStage (Stage::release);
+    }
+
+    void reset() noexcept
+    {
+        stage = Stage::idle;
+        value = 0.0f;
+    }
+
+    bool isActive() const noexcept { return stage != Stage::idle; }
+
+    /** Writes the next numSamples envelope values. */
+    void process (const Sub808Dsp::KernelTable& kernels, float* out, int numSamples) noexcept
+    {
+        int i = 0;
+
+        while (i < numSamples)
+        {
+            const int remaining = numSamples - i;
+
+            switch (stage)
+            {
+                case Stage::idle:
+                case Stage::sustain:
+                    std::fill (out + i, out + numSamples, value);
+                    return;
+
+                case Stage::hold:
+                {
+                    const int n = juce::jmin (remaining, samplesLeft);
+                    std::fill (out + i, out + i + n, value);
+                    i += n;
+
+                    if ((samplesLeft -= n) == 0)
+                        enterStage (Stage::decay);
+
+                    break;
+                }
+
+                case Stage::attack:
+                case Stage::decay:
+                case Stage::release:
+                {
+                    const int n = juce::jmin (remaining, samplesLeft);
+                    kernels.envelopeSegment (out + i, n, asymptote, offset, coefPowers, coefPowLanes, coef);
+                    value = asymptote + offset;
+                    i += n;
+
+                    if ((samplesLeft -= n) == 0)
+                    {
+                        out[i - 1] = endLevel; // the curve aims slightly past it
+                        finishStage();
+                    }
+
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    enum class Stage { idle, attack, hold, decay, sustain, release };
+
+    // How far past its end level each curve aims, as a fraction of full scale.
+    // A large attack ratio keeps the attack close to the convex RC charge of an
+    // analog envelope; the small decay/release ratio gives a -60 dB tail.
+    static constexpr float attackRatio       = 0.3f;
+    static constexpr float decayReleaseRatio = 0.001f;
+
+    void enterStage (Stage newStage) noexcept
+    {
+        stage = newStage;
+
+        switch (stage)
+        {
+            case Stage::attack:
+                // Scaled by the peak so soft notes keep the same shape
+                startCurve (peak, attackRatio * juce::jmax (peak, 1.0e-3f), params.attack);
+                break;
+
+            case Stage::hold:
+                samplesLeft = (int) (params.hold * (float) sampleRateHz);
+                value = peak;
+
+                if (samplesLeft <= 0)
+                    enterStage (Stage::decay);
+                break;
+
+            case Stage::decay:
+                startCurve (params.sustain * peak, decayReleaseRatio, params.decay);
+                break;
+
+            case Stage::release:
+                startCurve (0.0f, decayReleaseRatio, params.release);
+                break;
+
+            case Stage::sustain:
+                value = params.sustain * peak;
+
+                if (value <= 0.0f)
+                    reset();
+                break;
+
+            case Stage::idle:
+                reset();
+                break;
+        }
+    }
+
+    void finishStage() noexcept
+    {
+        value = endLevel; // land exactly, the curve aims slightly past it
+
+        switch (stage)
+        {
+            case Stage::attack:  enterStage (params.hold > 0.0f ? Stage::hold : Stage::decay); break;
+            case Stage::decay:   enterStage (Stage::sustain); break;
+            case Stage::release: enterStage (Stage::idle); break;
+            case Stage::idle:
+            case Stage::hold:
+            case Stage::sustain: break;
+        }
+    }
+
+    /** True if moving to newParams changes what the running stage does. */
+    bool affectsStage (const Parameters& newParams) const noexcept
+    {
+        switch (stage)
+        {
+            case Stage::attack:  return ! juce::exactlyEqual (newParams.attack, params.attack);
+            case Stage::hold:    return ! juce::exactlyEqual (newParams.hold, params.hold);
+            case Stage::decay:   return ! juce::exactlyEqual (newParams.decay, params.decay)
+                                     || ! juce::exactlyEqual (newParams.sustain, params.sustain);
+            case Stage::sustain: return ! juce::exactlyEqual (newParams.sustain, params.sustain);
+            case Stage::release: return ! juce::exactlyEqual (newParams.release, params.release);
+            case Stage::idle:    break;
+        }
+
+        return false;
+    }
+
+    /** Re-times the running stage from the current level after a parameter or
+        sample-rate change. */
+    void restartStage() noexcept
+    {
+        switch (stage)
+        {
+            case Stage::attack:
+            case Stage::decay:
+            case Stage::release:
+                enterStage (stage);
+                break;
+
+            case Stage::hold:
+                samplesLeft = juce::jmin (samplesLeft, (int) (params.hold * (float) sampleRateHz));
+
+                if (samplesLeft <= 0)
+                    enterStage (Stage::decay);
+                break;
+
+            case Stage::sustain:
+                // Glide to a new sustain level rather than jumping to it
+                if (! juce::exactlyEqual (params.sustain * peak, value))
+                    enterStage (Stage::decay);
+                break;
+
+            case Stage::idle:
+                break;
+        }
+    }
+
+    /** Sets up value[n] = asymptote + offset * coef^n, heading from the current
+        value to target over roughly `seconds` for a full-scale move. */
+    void startCurve (float target, float ratio, float seconds) noexcept
+    {
+        const auto curve = Sub808EnvelopeCurve::make (value, target, ratio, seconds, sampleRateHz);
+
+        endLevel    = target;
+        asymptote   = curve.asymptote;
+        offset      = curve.offset;
+        coef        = curve.coef;
+        samplesLeft = curve.length;
+
+        double p = 1.0;
+
+        for (auto& cp : coefPowers)
+            cp = (float) (p *= (double) coef);
+
+        coefPowLanes = coefPowers[Sub808Dsp::envelopeSegmentLanes - 1];
+
+        if (samplesLeft == 0)
+            finishStage();
+    }
+
+    double sampleRateHz = 44100.0;
+    Parameters params;
+
+    Stage stage = Stage::idle;
+    float value = 0.0f;
+    float peak  = 1.0f;
+
+    // Running curve
+    float asymptote = 0.0f, offset = 0.0f, coef = 0.0f, endLevel = 0.0f;
+    int   samplesLeft = 0;
+    alignas (64) float coefPowers[Sub808Dsp::envelopeSegmentLanes] {};
+    float coefPowLanes = 0.0f;
+};
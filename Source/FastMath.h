@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+    Reduced-precision replacements for the libm calls on the DSP path.
+
+    All of these are branch-free straight-line code, so they vectorise in the
+    kernels the same way the rest of the loop does. Accuracy is traded down
+    to what a float signal path can actually resolve. The error quoted for
+    each function was measured against long-double libm over the stated
+    domain, and covers every value the parameter ranges in
+    createParameterLayout() can produce; Tests/FastMathTests.cpp checks
+    both. Nothing calls these implicitly: code opts in by writing
+    Sub808FastMath:: where the precision is enough.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstring>
+
+namespace Sub808FastMath
+{
+    // Clamps and selects below are done on the float's bit pattern, as
+    // integer min / max. A float ?: with a constant arm gets turned back into
+    // a branch once GCC folds the arithmetic after it, which stops the
+    // calling loop vectorising; the integer forms stay vector selects.
+    forcedinline juce::int32 toBits (float x) noexcept
+    {
+        juce::int32 bits;
+        std::memcpy (&bits, &x, sizeof (bits));
+        return bits;
+    }
+
+    forcedinline float fromBits (juce::int32 bits) noexcept
+    {
+        float x;
+        std::memcpy (&x, &bits, sizeof (x));
+        return x;
+    }
+
+    /** x with its magnitude limited to limit (> 0). */
+    forcedinline float clampMagnitude (float x, float limit) noexcept
+    {
+        const juce::int32 bits = toBits (x);
+        const juce::int32 mag  = std::min (bits & 0x7fffffff, toBits (limit));
+        return fromBits ((bits & ~0x7fffffff) | mag);
+    }
+
+    /** sin (2 * pi * p) for p in [0, 1). Folds into [0, 1/4] turn and
+        evaluates a minimax odd polynomial. Max abs error 1.9e-7
+        (float std::sin of the scaled argument: 4.1e-7). The fold is abs /
+        copysign rather than selects, for the reason given above. */
+    forcedinline float sin2Pi (float p) noexcept
+    {
+        const float t = p - (float) (int) (p + 0.5f);               // [-0.5, 0.5], same sine
+        const float a = 0.25f - std::abs (std::abs (t) - 0.25f);    // [0, 0.25], sin (a) == |sin (t)|
+
+        const float x  = a * juce::MathConstants<float>::twoPi;
+        const float x2 = x * x;
+        const float s  = x * (9.9999997659e-1f + x2 * (-1.6666647635e-1f + x2 * (8.3328998233e-3f + x2 * (-1.9800897761e-4f + x2 * 2.5904884977e-6f))));
+        return std::copysign (s, t);
+    }
+
+    /** tanh (x) for any finite x, as a 13/6 rational in x. Saturates to
+        +-1 beyond |x| = 7.9. Max abs error 4.2e-7 (the worst float is
+        +-5.82787609), and the same relative error for |x| >= 1e-36; below
+        that the leading term goes denormal. */
+    forcedinline float tanh (float x) noexcept
+    {
+        x = clampMagnitude (x, 7.90531110f);
+
+        const float x2 = x * x;
+        const float p = x * (4.89352455891786e-03f + x2 * (6.37261928875436e-04f + x2 * (1.48572235717979e-05f
+                          + x2 * (5.12229709037114e-08f + x2 * (-8.60467152213735e-11f + x2 * (2.00018790482477e-13f
+                          + x2 * -2.76076847742355e-16f))))));
+        const float q = 4.89352518554385e-03f + x2 * (2.26843463243900e-03f + x2 * (1.18534705686654e-04f
+                          + x2 * 1.19825839466702e-06f));
+        return p / q;
+    }
+
+    /** 2^x. Rounds x to the nearest integer for the exponent bits and uses a
+        minimax polynomial on the remaining [-1/2, 1/2]. x is clamped to
+        [-126, 126], inside the normal float range. Max relative error 2.4e-7. */
+    forcedinline float exp2 (float x) noexcept
+    {
+        x = clampMagnitude (x, 126.0f);
+
+        const int   i = (int) (x + 126.5f) - 126; // positive before the cast, so truncation rounds
+        const float f = x - (float) i;
+
+        const float p = 1.0000000717e+0f + f * (6.9314696706e-1f + f * (2.4022119724e-1f + f * (5.5507132750e-2f
+                          + f * (9.6755413307e-3f + f * 1.3276471520e-3f))));
+
+        return p * fromBits ((i + 127) << 23);
+    }
+
+    /** log2 (x) for x > 0. Takes the exponent from the bits and a minimax
+        polynomial of the mantissa, centred on 1. Values below the smallest
+        normal float are treated as that. Max abs error 1.3e-7 over [0.5, 2);
+        further out the float result's own rounding takes over: 3.4e-7 over
+        2^+-8, 1.1e-6 over 2^+-20, 3.9e-6 over [2^-120, 2^120]. */
+    forcedinline float log2 (float x) noexcept
+    {
+        // Positive floats order the same as their bit patterns
+        const juce::int32 bits = std::max (toBits (x), toBits (1.17549435e-38f));
+
+        // Mantissa into [sqrt (1/2), sqrt (2)), where the polynomial is fitted
+        juce::int32 mantissaBits = (bits & 0x007fffff) | 0x3f800000;
+        const juce::int32 high = (juce::int32) ((juce::uint32) (toBits (1.41421356f) - mantissaBits) >> 31); // 1 above sqrt (2)
+        mantissaBits -= high << 23;
+
+        const float e = (float) (((bits >> 23) & 0xff) - 127 + high);
+        const float t = fromBits (mantissaBits) - 1.0f;
+        return e + t * (1.4426947724e+0f + t * (-7.2135714895e-1f + t * (4.8093944457e-1f + t * (-3.6008721476e-1f
+                     + t * (2.8670746177e-1f + t * (-2.5006906047e-1f + t * (2.3689033626e-1f + t * -1.4574436408e-1f)))))));
+    }
+
+    /** e^x, through exp2. Max relative error 3.6e-7 on [-3, 0] (every filter
+        coefficient the tone range can ask for) and 6.9e-7 for |x| <= 10. */
+    forcedinline float exp (float x) noexcept
+    {
+        return exp2 (x * 1.44269504f);
+    }
+
+    /** Frequency ratio for a pitch offset: 2^(semitones / 12). Max relative
+        error 3.5e-7 over +-36 semitones (0.0006 cents). */
+    forcedinline float semitonesToRatio (float semitones) noexcept
+    {
+        return exp2 (semitones * (1.0f / 12.0f));
+    }
+
+    /** 20 * log10 (gain) for gain > 0, through log2. Max abs error 1.5e-6 dB
+        over +-12 dB (the ducker's knee is 6 dB), 4.4e-6 dB over +-48 dB and
+        1.2e-5 dB over +-120 dB. */
+    forcedinline float gainToDecibels (float gain) noexcept
+    {
+        return 6.02059991f * log2 (gain);
+    }
+}
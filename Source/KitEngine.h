@@ -0,0 +1,260 @@
+/*
+  ==============================================================================
+
+    KitEngine.h
+    Drum-kit mode: up to 16 independent one-shot 808 slots, each answering a
+    range of MIDI notes with its own level, tuning, decay, drive and tone.
+
+    Slot state lives in one Sub808Dsp::KitLanes block (structure-of-arrays),
+    so every sounding slot is rendered by a single kernel call rather than
+    one voice object per slot. Envelope stage changes are the only per-slot
+    scalar work: a pass runs up to the next one, handles it and carries on.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+#include "Envelope.h"
+#include "FastMath.h"
+#include "VelocityDynamics.h"
+
+struct Sub808KitSlotSettings
+{
+    int   lowNote  = 36;
+    int   highNote = 36;
+    float gain          = 0.8f;
+    float tuneSemitones = 0.0f;   // relative to the played note
+    float decay         = 0.5f;   // seconds
+    float drive         = 0.1f;   // 0..1
+    float toneCutoff    = 2000.0f; // Hz
+
+    bool operator== (const Sub808KitSlotSettings& o) const noexcept
+    {
+        return lowNote == o.lowNote && highNote == o.highNote && juce::exactlyEqual (gain, o.gain)
+            && juce::exactlyEqual (tuneSemitones, o.tuneSemitones) && juce::exactlyEqual (decay, o.decay)
+            && juce::exactlyEqual (drive, o.drive) && juce::exactlyEqual (toneCutoff, o.toneCutoff);
+    }
+
+    bool operator!= (const Sub808KitSlotSettings& o) const noexcept { return ! operator== (o); }
+};
+
+class Sub808KitEngine
+{
+public:
+    static constexpr int numSlots      = Sub808Dsp::KitLanes::numLanes;
+    static constexpr int maxRenderSize = 128;
+
+    void prepare (double newSampleRate) noexcept
+    {
+        sampleRateHz = newSampleRate;
+
+        // Every coefficient depends on the rate
+        std::fill (std::begin (stale), std::end (stale), true);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (int v = 0; v < numSlots; ++v)
+            silenceLane (v);
+    }
+
+    /** Cheap when nothing changed. A new decay time applies from the next hit. */
+    void setSlot (int slot, const Sub808KitSlotSettings& s) noexcept
+    {
+        if (s == settings[slot] && ! stale[slot])
+            return;
+
+        settings[slot] = s;
+        stale[slot] = false;
+
+        tuneRatio[slot] = Sub808FastMath::semitonesToRatio (s.tuneSemitones);
+        lanes.phaseInc[slot] = noteHz[slot] * tuneRatio[slot] / (float) sampleRateHz;
+
+        // Same drive law as the main voice (see Sub808VoiceSettings), no color tilt
+        driveK[slot]    = s.drive > 0.0f ? juce::jmap (s.drive, 0.0f, 1.0f, 0.0f, 2.5f) : 0.0f;
+        toneOmega[slot] = 2.0f * juce::MathConstants<float>::pi * s.toneCutoff / (float) sampleRateHz;
+        updateDriveTone (slot);
+    }
+
+    /** The lowest slot whose note range holds the note, or -1. */
+    int findSlot (int note) const noexcept
+    {
+        for (int v = 0; v < numSlots; ++v)
+        {
+            const auto& s = settings[v];
+
+            if (note >= juce::jmin (s.lowNote, s.highNote) && note <= juce::jmax (s.lowNote, s.highNote))
+                return v;
+        }
+
+        return -1;
+    }
+
+    /** Restarts the slot like a hardware 808 voice: phase from zero, attack
+        from wherever its envelope currently is. The hit's dynamics set its
+        peak and shift the slot's drive and tone until the next hit. */
+    void noteOn (int slot, int note, const Sub808NoteDynamics& dynamics) noexcept
+    {
+        noteHz[slot] = (float) juce::MidiMessage::getMidiNoteInHertz (note);
+        peak[slot]   = juce::jlimit (0.0f, 1.0f, dynamics.level);
+
+        hit[slot] = dynamics;
+        updateDriveTone (slot);
+
+        lanes.phase[slot]    = 0.0f;
+        lanes.phaseInc[slot] = noteHz[slot] * tuneRatio[slot] / (float) sampleRateHz;
+
+        activeMask |= 1u << slot;
+        startAttack (slot);
+    }
+
+    bool isActive() const noexcept { return activeMask != 0; }
+
+    /** False once any slot's filter state has gone NaN or infinite. */
+    bool isFinite() const noexcept
+    {
+        for (auto z : lanes.toneZ)
+            if (! std::isfinite (z))
+                return false;
+
+        return true;
+    }
+
+    /** Renders numSamples (at most maxRenderSize) of every sounding slot and
+        hands each one to output (slot, samples, numSamples), gain applied. */
+    template <typename SlotOutput>
+    void render (const Sub808Dsp::KernelTable& kernels, int numSamples, SlotOutput&& output) noexcept
+    {
+        jassert (numSamples <= maxRenderSize);
+
+        const juce::uint32 sounding = activeMask;
+
+        if (sounding == 0)
+            return;
+
+        alignas (64) float tile[maxRenderSize * numSlots];
+
+        for (int i = 0; i < numSamples;)
+        {
+            if (activeMask == 0)
+            {
+                std::fill (tile + i * numSlots, tile + numSamples * numSlots, 0.0f);
+                break;
+            }
+
+            // Run every lane together up to the next envelope stage change
+            int run = numSamples - i;
+
+            for (int v = 0; v < numSlots; ++v)
+                if ((activeMask >> v) & 1u)
+                    run = juce::jmin (run, samplesLeft[v]);
+
+            kernels.kit (lanes, tile + i * numSlots, run);
+            i += run;
+
+            for (int v = 0; v < numSlots; ++v)
+                if (((activeMask >> v) & 1u) && (samplesLeft[v] -= run) == 0)
+                    finishStage (v);
+        }
+
+        alignas (64) float slotOut[maxRenderSize];
+
+        for (int v = 0; v < numSlots; ++v)
+        {
+            if (((sounding >> v) & 1u) == 0)
+                continue;
+
+            for (int i = 0; i < numSamples; ++i)
+                slotOut[i] = tile[i * numSlots + v] * settings[v].gain;
+
+            output (v, (const float*) slotOut, numSamples);
+        }
+    }
+
+private:
+    enum class Stage { idle, attack, decay };
+
+    // Fixed, click-free attack; the decay is the slot's own.
+    static constexpr float attackSeconds     = 0.001f;
+    static constexpr float attackRatio       = 0.3f;
+    static constexpr float decayReleaseRatio = 0.001f;
+
+    void updateDriveTone (int v) noexcept
+    {
+        auto c = Sub808DriveToneCoefficients::make (driveK[v], toneOmega[v], 0.0f, hit[v]);
+
+        if (c.driveK <= 0.0f)
+            c = Sub808DriveToneCoefficients::make (Sub808Dsp::KitLanes::transparentDriveK, toneOmega[v], 0.0f);
+
+        lanes.driveK[v]        = c.driveK;
+        lanes.driveNorm[v]     = c.driveNorm;
+        lanes.toneFeedback[v]  = c.toneFeedback;
+        lanes.toneInputGain[v] = c.toneInputGain;
+    }
+
+    void startAttack (int v) noexcept
+    {
+        stage[v] = Stage::attack;
+
+        const float current = lanes.envAsymptote[v] + lanes.envOffset[v];
+        startCurve (v, Sub808EnvelopeCurve::make (current, peak[v], attackRatio * juce::jmax (peak[v], 1.0e-3f),
+                                                  attackSeconds, sampleRateHz));
+    }
+
+    void startDecay (int v) noexcept
+    {
+        stage[v] = Stage::decay;
+        startCurve (v, Sub808EnvelopeCurve::make (peak[v], 0.0f, decayReleaseRatio, settings[v].decay, sampleRateHz));
+    }
+
+    void startCurve (int v, const Sub808EnvelopeCurve& curve) noexcept
+    {
+        lanes.envAsymptote[v] = curve.asymptote;
+        lanes.envOffset[v]    = curve.offset;
+        lanes.envCoef[v]      = curve.coef;
+        samplesLeft[v]        = curve.length;
+
+        if (curve.length == 0)
+            finishStage (v);
+    }
+
+    void finishStage (int v) noexcept
+    {
+        if (stage[v] == Stage::attack)
+            startDecay (v);
+        else
+            silenceLane (v);
+    }
+
+    void silenceLane (int v) noexcept
+    {
+        stage[v] = Stage::idle;
+        activeMask &= ~(1u << v);
+
+        lanes.envAsymptote[v] = 0.0f;
+        lanes.envOffset[v]    = 0.0f;
+        lanes.envCoef[v]      = 0.0f;
+        lanes.toneZ[v]        = 0.0f;
+        samplesLeft[v]        = 0;
+    }
+
+    double sampleRateHz = 44100.0;
+
+    Sub808Dsp::KitLanes lanes;
+    juce::uint32 activeMask = 0;
+
+    Sub808KitSlotSettings settings[numSlots];
+    bool  stale[numSlots] {};
+    Stage stage[numSlots] {};
+    int   samplesLeft[numSlots] {};
+    float peak[numSlots] {};
+    float noteHz[numSlots] {};
+    float tuneRatio[numSlots] {};
+    float driveK[numSlots] {};    // from the slot's knob, before the hit's dynamics
+    float toneOmega[numSlots] {};
+    Sub808NoteDynamics hit[numSlots];
+};
@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+
+    PatternEngine.h
+    Host-synced playback of the step patterns in Patterns.h.
+
+    On the message thread a pattern is compiled into a flat event timeline,
+    sorted by position, with an index of the first event in every beat. The
+    timeline reaches the audio thread through the command queue. There the
+    sequencer keeps a cursor into it. While the host plays continuously it
+    only walks that cursor. After a jump, a loop wrap or a pattern change
+    it re-seeks through the beat index. So each block costs O(events in the
+    block), whatever the pattern length or playhead movement.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Patterns.h"
+#include "EngineCommands.h"
+
+struct Sub808PatternEvent
+{
+    double ppq;        // from the start of the pattern
+    int    note;       // MIDI note, or noteOff
+    bool   accent;
+    bool   slide;
+
+    static constexpr int noteOff = -1;
+};
+
+//==============================================================================
+/** A pattern compiled for one root note. Immutable once built. */
+struct Sub808PatternTimeline : public Sub808EngineResource
+{
+    double lengthPpq = 0.0;
+    std::vector<Sub808PatternEvent> events; // sorted, all within [0, lengthPpq)
+    std::vector<int> beatStart;             // first event at or after each whole beat
+
+    /** Message thread only: parses and sorts, allocates. */
+    static std::unique_ptr<Sub808PatternTimeline> compile (const Sub808Pattern& pattern, int rootNote)
+    {
+        struct Step { int note = -1; bool accent = false, slide = false; };
+        std::vector<Step> steps;
+
+        for (auto& token : juce::StringArray::fromTokens (pattern.steps, " ", {}))
+        {
+            Step s;
+
+            if (token.isNotEmpty() && token != ".")
+            {
+                s.note   = juce::jlimit (0, 127, rootNote + token.getIntValue());
+                s.accent = token.containsChar ('a');
+                s.slide  = token.containsChar ('s');
+            }
+
+            steps.push_back (s);
+        }
+
+        auto timeline = std::make_unique<Sub808PatternTimeline>();
+        const int numSteps = (int) steps.size();
+        timeline->lengthPpq = juce::jmax (1, numSteps) * pattern.stepPpq;
+
+        for (int i = 0; i < numSteps; ++i)
+        {
+            const auto& s = steps[(size_t) i];
+
+            if (s.note < 0)
+                continue;
+
+            const auto& prev = steps[(size_t) ((i + numSteps - 1) % numSteps)];
+            const auto& next = steps[(size_t) ((i + 1) % numSteps)];
+            const double start = i * pattern.stepPpq;
+
+            // A slide only means something coming from a note; the note it
+            // comes from is tied over instead of getting a note-off.
+            timeline->events.push_back ({ start, s.note, s.accent, s.slide && prev.note >= 0 });
+
+            if (! (next.slide && next.note >= 0))
+                timeline->events.push_back ({ start + pattern.gate * pattern.stepPpq,
+                                              Sub808PatternEvent::noteOff, false, false });
+        }
+
+        // Note-offs sort ahead of note-ons at the same position
+        std::stable_sort (timeline->events.begin(), timeline->events.end(),
+                          [] (const Sub808PatternEvent& a, const Sub808PatternEvent& b)
+                          {
+                              return ! juce::exactlyEqual (a.ppq, b.ppq) ? a.ppq < b.ppq
+                                                                         : (a.note == Sub808PatternEvent::noteOff && b.note != Sub808PatternEvent::noteOff);
+                          });
+
+        const int numBeats = (int) std::ceil (timeline->lengthPpq);
+        timeline->beatStart.resize ((size_t) numBeats + 1);
+
+        for (int beat = 0, e = 0; beat <= numBeats; ++beat)
+        {
+            while (e < (int) timeline->events.size() && timeline->events[(size_t) e].ppq < beat)
+                ++e;
+
+            timeline->beatStart[(size_t) beat] = e;
+        }
+
+        return timeline;
+    }
+
+    /** Index of the first event at or after ppq (0 <= ppq < lengthPpq). */
+    int seek (double ppq) const noexcept
+    {
+        const int beat = juce::jlimit (0, (int) beatStart.size() - 1, (int) ppq);
+        int e = beatStart[(size_t) beat];
+
+        while (e < (int) events.size() && events[(size_t) e].ppq < ppq)
+            ++e;
+
+        return e;
+    }
+};
+
+//==============================================================================
+/** Audio-thread side: turns the playhead position into the timeline events
+    due in the current block. */
+class Sub808PatternSequencer
+{
+public:
+    struct Event
+    {
+        int  samplePosition;
+        int  note;         // MIDI note, or Sub808PatternEvent::noteOff
+        bool accent;
+        bool slide;
+    };
+
+    static constexpr int maxEventsPerBlock = 256;
+
+    void reset() noexcept
+    {
+        current = nullptr;
+        noteSounding = false;
+    }
+
+    /** Fills out with the events due in this block, in order, and returns how
+        many there are. With no timeline (pattern off) or a stopped transport
+        it only makes sure the last pattern note is released. */
+    int process (const Sub808PatternTimeline* timeline, const juce::AudioPlayHead::PositionInfo* position,
+                 double sampleRate, int numSamples, Event* out) noexcept
+    {
+        numOut = 0;
+
+        // An empty block (some hosts send them to flush parameters) isn't a
+        // stop: leave the sounding note and the cursor exactly as they are.
+        if (numSamples <= 0)
+            return 0;
+
+        output = out;
+        blockSamples = numSamples;
+
+        const auto bpm = position != nullptr ? position->getBpm() : juce::Optional<double>();
+        const auto ppq = position != nullptr ? position->getPpqPosition() : juce::Optional<double>();
+
+        if (position == nullptr || timeline == nullptr || timeline->events.empty() || ! position->getIsPlaying()
+             || ! bpm.hasValue() || ! ppq.hasValue() || *bpm <= 0.0)
+        {
+            if (noteSounding)
+                emit (0, { 0.0, Sub808PatternEvent::noteOff, false, false });
+
+            current = nullptr;
+            return numOut;
+        }
+
+        samplesPerPpq = sampleRate * 60.0 / *bpm;
+
+        const double blockStart = *ppq;
+        const double blockEnd   = blockStart + numSamples / samplesPerPpq;
+
+        // A new timeline or a playhead more than a sample away from where the
+        // last block ended (jump, scrub, loop wrap) needs a seek rather than
+        // a cursor walk.
+        if (timeline != current || std::abs (blockStart - expectedPpq) * samplesPerPpq > 1.0)
+        {
+            current = timeline;
+            cursor  = -1;
+
+            if (noteSounding)
+                emit (0, { 0.0, Sub808PatternEvent::noteOff, false, false });
+        }
+
+        // A block that crosses the end of the host's loop also plays the
+        // start of the loop, on the samples after the wrap.
+        const auto loop = position->getLoopPoints();
+
+        if (position->getIsLooping() && loop.hasValue() && loop->ppqEnd > loop->ppqStart
+             && blockStart < loop->ppqEnd && blockEnd > loop->ppqEnd)
+        {
+            playSegment (blockStart, loop->ppqEnd, 0);
+
+            const int wrapSample = (int) ((loop->ppqEnd - blockStart) * samplesPerPpq);
+            cursor = -1;
+            playSegment (loop->ppqStart, loop->ppqStart + (blockEnd - loop->ppqEnd), wrapSample);
+            expectedPpq = loop->ppqStart + (blockEnd - loop->ppqEnd);
+        }
+        else
+        {
+            playSegment (blockStart, blockEnd, 0);
+            expectedPpq = blockEnd;
+        }
+
+        return numOut;
+    }
+
+    bool isNoteSounding() const noexcept { return noteSounding; }
+
+private:
+    /** Emits the events in [from, to) of host time, the first sample of
+        which is firstSample. */
+    void playSegment (double from, double to, int firstSample) noexcept
+    {
+        const auto& events = current->events;
+        const double length = current->lengthPpq;
+
+        if (cursor < 0)
+        {
+            repeatStart = std::floor (from / length) * length;
+            cursor = current->seek (from - repeatStart);
+        }
+
+        for (;;)
+        {
+            if (cursor >= (int) events.size())
+            {
+                cursor = 0;
+                repeatStart += length;
+            }
+
+            const auto& e = events[(size_t) cursor];
+            const double at = repeatStart + e.ppq;
+
+            if (at >= to || numOut == maxEventsPerBlock)
+                break;
+
+            // First sample at or after the event (the epsilon absorbs rounding)
+            emit (firstSample + (int) std::ceil ((at - from) * samplesPerPpq - 1.0e-6), e);
+            ++cursor;
+        }
+    }
+
+    void emit (int samplePosition, const Sub808PatternEvent& e) noexcept
+    {
+        if (numOut == maxEventsPerBlock)
+            return;
+
+        output[numOut++] = { juce::jlimit (0, juce::jmax (0, blockSamples - 1), samplePosition), e.note, e.accent, e.slide };
+        noteSounding = e.note != Sub808PatternEvent::noteOff;
+    }
+
+    const Sub808PatternTimeline* current = nullptr;
+    int    cursor = -1;
+    double repeatStart = 0.0; // host position where the cursor's pattern repeat starts
+    double expectedPpq = 0.0;
+    double samplesPerPpq = 1.0;
+    int    blockSamples = 0;
+    bool   noteSounding = false;
+
+    Event* output = nullptr;
+    int    numOut = 0;
+};
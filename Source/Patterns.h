@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    Patterns.h
+    Factory step patterns for the host-synced pattern engine.
+
+    A pattern is one token per step, separated by spaces:
+        .       rest
+        7       note, in semitones above the pattern root
+        7a      accented
+        7s      slides (glides, without a retrigger) from the previous note
+        7as     both
+    PatternEngine.h compiles these into an event timeline.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct Sub808Pattern
+{
+    const char* name;
+    double stepPpq;   // step length in quarter notes: 0.25 = sixteenths
+    float  gate;      // note length as a fraction of a step
+    const char* steps;
+};
+
+namespace Sub808Patterns
+{
+    inline constexpr Sub808Pattern factory[] =
+    {
+        { "Four On The Floor", 0.25, 0.50f, "0a . . . 0 . . . 0a . . . 0 . . ." },
+        { "Trap Bounce",       0.25, 0.60f, "0a . . 0 . . 0 . . . 0a . 0 . 12s ." },
+        { "Drill Slide",       0.25, 0.70f, "0a . . 5s . . 0 . . 3 . . 0as . 7s ." },
+        { "Halftime Boom",     0.25, 0.90f, "0a . . . . . . . . . 0 . 7s . . ." },
+        { "Rolling Sixteens",  0.25, 0.45f, "0a 0 0 0 0a 0 0 0 0a 0 0 0 0a 0 12 0" },
+        { "Octave Jumps",      0.25, 0.50f, "0a . 12 . 0 . 12s . 0a . 12 . 0 12 0 12s" },
+        { "Triplet Roll",      1.0 / 6.0, 0.50f, "0a 0 0 0a 0 0 0a 0 0 0a 0 0 0a 7s 5s 0s 0 0 0a . . 0 . ." },
+    };
+
+    inline constexpr int numFactory = (int) (sizeof (factory) / sizeof (factory[0]));
+
+    inline juce::StringArray getFactoryNames()
+    {
+        juce::StringArray names;
+
+        for (auto& p : factory)
+            names.add (p.name);
+
+        return names;
+    }
+}
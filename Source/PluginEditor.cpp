@@ -11,63 +11,160 @@ Sub808AudioProcessorEditor::Sub808AudioProcessorEditor (Sub808AudioProcessor& p)
     setupSlider (decaySlider);
     setupSlider (sustainSlider);
     setupSlider (releaseSlider);
+    setupSlider (holdSlider);
+    setupSlider (velocitySlider);
 
     setupSlider (pitchSlider);
     setupSlider (glideSlider);
     setupSlider (driveSlider);
     setupSlider (colorSlider);
     setupSlider (toneSlider);
+    setupChoiceBox (velCurveBox, "velCurve");
+    setupSlider (velDriveSlider);
+    setupSlider (velToneSlider);
+
+    setupSlider (voicesSlider);
+    setupSlider (detuneSlider);
+    setupSlider (spreadSlider);
+    setupSlider (blendSlider);
+    setupSlider (subSlider);
+    setupSlider (octaveSlider);
+
+    setupSlider (duckThresholdSlider);
+    setupSlider (duckDepthSlider);
+    setupSlider (duckAttackSlider);
+    setupSlider (duckReleaseSlider);
+    setupChoiceBox (duckDetectorBox, "duckDetector");
+    setupChoiceBox (accentSourceBox, "accentSource");
+    setupSlider (accentAmountSlider);
 
     gainAttach    = std::make_unique<Attachment> (audioProcessor.apvts, "gain",           gainSlider);
     attackAttach  = std::make_unique<Attachment> (audioProcessor.apvts, "attack",         attackSlider);
     decayAttach   = std::make_unique<Attachment> (audioProcessor.apvts, "decay",          decaySlider);
     sustainAttach = std::make_unique<Attachment> (audioProcessor.apvts, "sustain",        sustainSlider);
     releaseAttach = std::make_unique<Attachment> (audioProcessor.apvts, "release",        releaseSlider);
+    holdAttach    = std::make_unique<Attachment> (audioProcessor.apvts, "hold",           holdSlider);
+    velocityAttach = std::make_unique<Attachment> (audioProcessor.apvts, "velocitySens",  velocitySlider);
 
     pitchAttach  = std::make_unique<Attachment> (audioProcessor.apvts, "pitchSemitones", pitchSlider);
     glideAttach  = std::make_unique<Attachment> (audioProcessor.apvts, "glideTime",      glideSlider);
     driveAttach  = std::make_unique<Attachment> (audioProcessor.apvts, "drive",          driveSlider);
     colorAttach  = std::make_unique<Attachment> (audioProcessor.apvts, "color",          colorSlider);
     toneAttach   = std::make_unique<Attachment> (audioProcessor.apvts, "toneCutoff",     toneSlider);
+    velCurveAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (audioProcessor.apvts, "velCurve", velCurveBox);
+    velDriveAttach = std::make_unique<Attachment> (audioProcessor.apvts, "velDrive",     velDriveSlider);
+    velToneAttach  = std::make_unique<Attachment> (audioProcessor.apvts, "velTone",      velToneSlider);
+
+    voicesAttach = std::make_unique<Attachment> (audioProcessor.apvts, "unisonVoices",   voicesSlider);
+    detuneAttach = std::make_unique<Attachment> (audioProcessor.apvts, "unisonDetune",   detuneSlider);
+    spreadAttach = std::make_unique<Attachment> (audioProcessor.apvts, "unisonSpread",   spreadSlider);
+    blendAttach  = std::make_unique<Attachment> (audioProcessor.apvts, "unisonBlend",    blendSlider);
+    subAttach    = std::make_unique<Attachment> (audioProcessor.apvts, "subOctave",      subSlider);
+    octaveAttach = std::make_unique<Attachment> (audioProcessor.apvts, "octaveUp",       octaveSlider);
+
+    duckThresholdAttach = std::make_unique<Attachment> (audioProcessor.apvts, "duckThreshold", duckThresholdSlider);
+    duckDepthAttach     = std::make_unique<Attachment> (audioProcessor.apvts, "duckDepth",     duckDepthSlider);
+    duckAttackAttach    = std::make_unique<Attachment> (audioProcessor.apvts, "duckAttack",    duckAttackSlider);
+    duckReleaseAttach   = std::make_unique<Attachment> (audioProcessor.apvts, "duckRelease",   duckReleaseSlider);
+    duckDetectorAttach  = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (audioProcessor.apvts, "duckDetector", duckDetectorBox);
+    accentSourceAttach  = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (audioProcessor.apvts, "accentSource", accentSourceBox);
+    accentAmountAttach  = std::make_unique<Attachment> (audioProcessor.apvts, "accentAmount",  accentAmountSlider);
 
     addAndMakeVisible (gainSlider);
     addAndMakeVisible (attackSlider);
     addAndMakeVisible (decaySlider);
     addAndMakeVisible (sustainSlider);
     addAndMakeVisible (releaseSlider);
+    addAndMakeVisible (holdSlider);
+    addAndMakeVisible (velocitySlider);
 
     addAndMakeVisible (pitchSlider);
     addAndMakeVisible (glideSlider);
     addAndMakeVisible (driveSlider);
     addAndMakeVisible (colorSlider);
     addAndMakeVisible (toneSlider);
+    addAndMakeVisible (velCurveBox);
+    addAndMakeVisible (velDriveSlider);
+    addAndMakeVisible (velToneSlider);
+
+    addAndMakeVisible (voicesSlider);
+    addAndMakeVisible (detuneSlider);
+    addAndMakeVisible (spreadSlider);
+    addAndMakeVisible (blendSlider);
+    addAndMakeVisible (subSlider);
+    addAndMakeVisible (octaveSlider);
+
+    addAndMakeVisible (duckThresholdSlider);
+    addAndMakeVisible (duckDepthSlider);
+    addAndMakeVisible (duckAttackSlider);
+    addAndMakeVisible (duckReleaseSlider);
+    addAndMakeVisible (duckDetectorBox);
+    addAndMakeVisible (accentSourceBox);
+    addAndMakeVisible (accentAmountSlider);
 
     configureLabel (gainLabel,    "GAIN");
     configureLabel (attackLabel,  "ATTACK");
     configureLabel (decayLabel,   "DECAY");
     configureLabel (sustainLabel, "SUSTAIN");
     configureLabel (releaseLabel, "RELEASE");
+    configureLabel (holdLabel,    "HOLD");
+    configureLabel (velocityLabel, "VEL");
 
     configureLabel (pitchLabel, "PITCH");
     configureLabel (glideLabel, "GLIDE");
     configureLabel (driveLabel, "DRIVE");
     configureLabel (colorLabel, "COLOR");
     configureLabel (toneLabel,  "TONE");
+    configureLabel (velCurveLabel, "VEL CURVE");
+    configureLabel (velDriveLabel, "VEL DRIVE");
+    configureLabel (velToneLabel,  "VEL TONE");
+
+    configureLabel (voicesLabel, "VOICES");
+    configureLabel (detuneLabel, "DETUNE");
+    configureLabel (spreadLabel, "SPREAD");
+    configureLabel (blendLabel,  "BLEND");
+    configureLabel (subLabel,    "SUB");
+    configureLabel (octaveLabel, "OCT UP");
+
+    configureLabel (duckThresholdLabel, "SC THRESH");
+    configureLabel (duckDepthLabel,     "SC DEPTH");
+    configureLabel (duckAttackLabel,    "SC ATTACK");
+    configureLabel (duckReleaseLabel,   "SC RELEASE");
+    configureLabel (duckDetectorLabel,  "SC DETECT");
+    configureLabel (accentSourceLabel,  "ACCENT");
+    configureLabel (accentAmountLabel,  "ACC AMT");
 
     setupPresetBox();
     populatePresets();
+    setupMorphStrip();
+    setupPatternStrip();
+
+    addAndMakeVisible (panicButton);
+    panicButton.setTooltip ("Silence the engine immediately");
+    panicButton.onClick = [this] { audioProcessor.sendPanic(); };
+
+    addAndMakeVisible (multirateToggle);
+    multirateToggle.setTooltip ("Render the sub core at a reduced internal rate at high host sample rates");
+    multirateToggle.setColour (juce::ToggleButton::textColourId, juce::Colour::fromRGB (200, 200, 210));
+    multirateAttach = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (audioProcessor.apvts, "multirate", multirateToggle);
+
+    addAndMakeVisible (kitToggle);
+    kitToggle.setTooltip ("Drum-kit mode: note ranges trigger independent slots, each on its own output bus (slot settings are host parameters)");
+    kitToggle.setColour (juce::ToggleButton::textColourId, juce::Colour::fromRGB (200, 200, 210));
+    kitAttach = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (audioProcessor.apvts, "kitMode", kitToggle);
 
     // Removed tabs creation and buildTabs() since tabs are not used now
     // tabs = std::make_unique<juce::TabbedComponent>(juce::TabbedButtonBar::TabsAtTop);
     // addAndMakeVisible (*tabs);
     // buildTabs();
 
-    setSize (640, 260);
+    setSize (640, 540);
 }
 
 Sub808AudioProcessorEditor::~Sub808AudioProcessorEditor()
 {
     presetBox.onChange = nullptr;
+    panicButton.onClick = nullptr;
     setLookAndFeel (nullptr);
 }
 
@@ -142,21 +239,59 @@ void Sub808AudioProcessorEditor::resized()
         const int comboH = 26;
         auto right = topBar.reduced (12, 9);
         presetBox.setBounds ({ right.getRight() - comboW, right.getY(), comboW, comboH });
+
+        const int panicW = 70;
+        panicButton.setBounds ({ presetBox.getX() - 8 - panicW, right.getY(), panicW, comboH });
+
+        const int multirateW = 110;
+        multirateToggle.setBounds ({ panicButton.getX() - 8 - multirateW, right.getY(), multirateW, comboH });
+
+        const int kitW = 60;
+        kitToggle.setBounds ({ multirateToggle.getX() - 8 - kitW, right.getY(), kitW, comboH });
     }
 
-    // Controls area: two rows with padding
+    // Morph strip (40 px): [MORPH] [A] ---- morph ---- [B]
+    auto morphStrip = area.removeFromTop (40).reduced (12, 7);
+    {
+        const int toggleW = 80;
+        const int comboW  = 150;
+        morphToggle.setBounds (morphStrip.removeFromLeft (toggleW));
+        morphABox.setBounds (morphStrip.removeFromLeft (comboW));
+        morphBBox.setBounds (morphStrip.removeFromRight (comboW));
+        morphSlider.setBounds (morphStrip.reduced (8, 0));
+    }
+
+    // Pattern strip (40 px): [PATTERN] [pattern] ---- accent ---- [root]
+    auto patternStrip = area.removeFromTop (40).reduced (12, 7);
+    {
+        const int toggleW = 80;
+        const int comboW  = 150;
+        const int rootW   = 110;
+        patternToggle.setBounds (patternStrip.removeFromLeft (toggleW));
+        patternBox.setBounds (patternStrip.removeFromLeft (comboW));
+        patternRootSlider.setBounds (patternStrip.removeFromRight (rootW));
+        patternAccentSlider.setBounds (patternStrip.reduced (8, 0));
+    }
+
+    // Controls area: four rows with padding
     auto controlsArea = area.reduced (8, 6);
-    auto rowHeight = (controlsArea.getHeight() - 16) / 2;
+    auto rowHeight = (controlsArea.getHeight() - 48) / 4;
     auto row1 = controlsArea.removeFromTop (rowHeight);
     controlsArea.removeFromTop (16);
-    auto row2 = controlsArea;
+    auto row2 = controlsArea.removeFromTop (rowHeight);
+    controlsArea.removeFromTop (16);
+    auto row3 = controlsArea.removeFromTop (rowHeight);
+    controlsArea.removeFromTop (16);
+    auto row4 = controlsArea;
 
     layoutKnobRow (row1, {
-        { &attackSlider,  &attackLabel },
-        { &decaySlider,   &decayLabel },
-        { &sustainSlider, &sustainLabel },
-        { &releaseSlider, &releaseLabel },
-        { &gainSlider,    &gainLabel }
+        { &attackSlider,   &attackLabel },
+        { &holdSlider,     &holdLabel },
+        { &decaySlider,    &decayLabel },
+        { &sustainSlider,  &sustainLabel },
+        { &releaseSlider,  &releaseLabel },
+        { &velocitySlider, &velocityLabel },
+        { &gainSlider,     &gainLabel }
     });
 
     layoutKnobRow (row2, {
@@ -164,14 +299,36 @@ void Sub808AudioProcessorEditor::resized()
         { &glideSlider, &glideLabel },
         { &driveSlider, &driveLabel },
         { &colorSlider, &colorLabel },
-        { &toneSlider,  &toneLabel }
+        { &toneSlider,  &toneLabel },
+        { &velCurveBox,    &velCurveLabel },
+        { &velDriveSlider, &velDriveLabel },
+        { &velToneSlider,  &velToneLabel }
+    });
+
+    layoutKnobRow (row3, {
+        { &voicesSlider, &voicesLabel },
+        { &detuneSlider, &detuneLabel },
+        { &spreadSlider, &spreadLabel },
+        { &blendSlider,  &blendLabel },
+        { &subSlider,    &subLabel },
+        { &octaveSlider, &octaveLabel }
+    });
+
+    layoutKnobRow (row4, {
+        { &duckThresholdSlider, &duckThresholdLabel },
+        { &duckDepthSlider,     &duckDepthLabel },
+        { &duckAttackSlider,    &duckAttackLabel },
+        { &duckReleaseSlider,   &duckReleaseLabel },
+        { &duckDetectorBox,     &duckDetectorLabel },
+        { &accentSourceBox,     &accentSourceLabel },
+        { &accentAmountSlider,  &accentAmountLabel }
     });
 
     // Removed setting presetListComponent bounds since tabs are no longer used
 }
 
 void Sub808AudioProcessorEditor::layoutKnobRow (juce::Rectangle<int> rowArea,
-                                                std::initializer_list<std::pair<juce::Slider*, juce::Label*>> controls,
+                                                std::initializer_list<std::pair<juce::Component*, juce::Label*>> controls,
                                                 int padding)
 {
     const int count = (int) controls.size();
@@ -179,6 +336,7 @@ void Sub808AudioProcessorEditor::layoutKnobRow (juce::Rectangle<int> rowArea,
     const int cellW = rowArea.getWidth() / count;
     const int labelH = 18;
     const int topPad = 6;
+    const int comboH = 26;
 
     int i = 0;
     for (auto pair : controls)
@@ -186,6 +344,11 @@ void Sub808AudioProcessorEditor::layoutKnobRow (juce::Rectangle<int> rowArea,
         auto cell = rowArea.withX (rowArea.getX() + i * cellW).withWidth (cellW).reduced (padding);
         auto labelArea = juce::Rectangle<int> (cell.getX(), cell.getY(), cell.getWidth(), labelH);
         auto knobArea  = cell.withTrimmedTop (labelH + topPad);
+
+        // Choice parameters sit as a combo box in the middle of the knob's cell
+        if (dynamic_cast<juce::ComboBox*> (pair.first) != nullptr)
+            knobArea = knobArea.withSizeKeepingCentre (knobArea.getWidth(), comboH);
+
         if (pair.second) pair.second->setBounds (labelArea);
         if (pair.first)  pair.first ->setBounds (knobArea);
         ++i;
@@ -202,6 +365,15 @@ void Sub808AudioProcessorEditor::setupSlider (juce::Slider& s)
     s.setColour (juce::Slider::textBoxBackgroundColourId, juce::Colour::fromRGB (28, 28, 36));
 }
 
+void Sub808AudioProcessorEditor::setupChoiceBox (juce::ComboBox& box, const juce::String& parameterID)
+{
+    // Items in the parameter's own order, so the attachment's IDs line up
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*> (audioProcessor.apvts.getParameter (parameterID)))
+        box.addItemList (choice->choices, 1);
+
+    box.setJustificationType (juce::Justification::centred);
+}
+
 void Sub808AudioProcessorEditor::configureLabel (juce::Label& l, const juce::String& text)
 {
     l.setText (text, juce::dontSendNotification);
@@ -224,22 +396,68 @@ void Sub808AudioProcessorEditor::setupPresetBox()
     };
 }
 
+void Sub808AudioProcessorEditor::setupMorphStrip()
+{
+    const auto names = Sub808Presets::getFactoryNames();
+
+    for (auto* box : { &morphABox, &morphBBox })
+    {
+        box->addItemList (names, 1);
+        box->setJustificationType (juce::Justification::centred);
+        addAndMakeVisible (*box);
+    }
+
+    morphABox.setTooltip ("Morph source preset");
+    morphBBox.setTooltip ("Morph target preset");
+
+    morphSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    morphSlider.setTextBoxStyle (juce::Slider::NoTextBox, true, 0, 0);
+    morphSlider.setColour (juce::Slider::trackColourId, juce::Colour::fromRGB (120, 200, 255));
+    addAndMakeVisible (morphSlider);
+
+    morphToggle.setColour (juce::ToggleButton::textColourId, juce::Colour::fromRGB (200, 200, 210));
+    addAndMakeVisible (morphToggle);
+
+    morphOnAttach = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>   (audioProcessor.apvts, "morphOn",     morphToggle);
+    morphAAttach  = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (audioProcessor.apvts, "morphA",      morphABox);
+    morphBAttach  = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (audioProcessor.apvts, "morphB",      morphBBox);
+    morphAttach   = std::make_unique<Attachment>                                             (audioProcessor.apvts, "morphAmount", morphSlider);
+}
+
+void Sub808AudioProcessorEditor::setupPatternStrip()
+{
+    patternBox.addItemList (Sub808Patterns::getFactoryNames(), 1);
+    patternBox.setJustificationType (juce::Justification::centred);
+    patternBox.setTooltip ("Step pattern, played in sync with the host transport");
+    addAndMakeVisible (patternBox);
+
+    patternAccentSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    patternAccentSlider.setTextBoxStyle (juce::Slider::NoTextBox, true, 0, 0);
+    patternAccentSlider.setColour (juce::Slider::trackColourId, juce::Colour::fromRGB (255, 170, 90));
+    patternAccentSlider.setTooltip ("Accent depth: how much quieter unaccented steps play");
+    addAndMakeVisible (patternAccentSlider);
+
+    patternRootSlider.setSliderStyle (juce::Slider::IncDecButtons);
+    patternRootSlider.setTextBoxStyle (juce::Slider::TextBoxLeft, false, 50, 26);
+    patternRootSlider.setTooltip ("Pattern root note");
+    addAndMakeVisible (patternRootSlider);
+
+    patternToggle.setColour (juce::ToggleButton::textColourId, juce::Colour::fromRGB (200, 200, 210));
+    addAndMakeVisible (patternToggle);
+
+    patternOnAttach     = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>   (audioProcessor.apvts, "patternOn",     patternToggle);
+    patternAttach       = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (audioProcessor.apvts, "pattern",       patternBox);
+    patternAccentAttach = std::make_unique<Attachment>                                             (audioProcessor.apvts, "patternAccent", patternAccentSlider);
+    patternRootAttach   = std::make_unique<Attachment>                                             (audioProcessor.apvts, "patternRoot",   patternRootSlider);
+}
+
 void Sub808AudioProcessorEditor::populatePresets()
 {
     presets.clear();
     presetBox.clear();
 
-    // Preset { name, gain, attack, decay, sustain, release, pitchSemitones, glideTime, drive, color, toneCutoff }
-    presets.add (new Preset { "Default Clean 808", 0.70f, 0.02f, 0.20f, 0.60f, 0.30f, 0.0f, 0.00f, 0.10f,  0.00f, 300.0f });
-    presets.add (new Preset { "Spinz 808",          0.85f, 0.00f, 0.12f, 0.55f, 0.20f, 0.0f, 0.02f, 0.45f,  0.35f, 450.0f });
-    presets.add (new Preset { "Zay 808",            0.80f, 0.01f, 0.25f, 0.65f, 0.30f, 0.0f, 0.03f, 0.25f, -0.20f, 280.0f });
-    presets.add (new Preset { "Subby Glide",        0.75f, 0.02f, 0.30f, 0.60f, 0.40f, -2.0f, 0.12f, 0.15f, -0.10f, 220.0f });
-    presets.add (new Preset { "Punch 808",          0.90f, 0.00f, 0.10f, 0.50f, 0.18f, 0.0f, 0.01f, 0.50f,  0.40f, 520.0f });
-    presets.add (new Preset { "Warm Tape 808",      0.78f, 0.02f, 0.22f, 0.62f, 0.28f, -1.0f, 0.02f, 0.30f, -0.35f, 260.0f });
-    presets.add (new Preset { "Distorted 808",      0.95f, 0.00f, 0.12f, 0.50f, 0.22f, 0.0f, 0.00f, 0.75f,  0.45f, 600.0f });
-    presets.add (new Preset { "Long Boom",          0.80f, 0.01f, 0.40f, 0.60f, 0.60f, 0.0f, 0.00f, 0.20f, -0.25f, 240.0f });
-    presets.add (new Preset { "Soft Attack 808",    0.70f, 0.06f, 0.28f, 0.58f, 0.35f, 0.0f, 0.00f, 0.15f, -0.15f, 300.0f });
-    presets.add (new Preset { "Tight Click 808",    0.88f, 0.00f, 0.08f, 0.45f, 0.15f, 0.0f, 0.00f, 0.40f,  0.50f, 650.0f });
+    for (auto& p : Sub808Presets::factory)
+        presets.add (&p);
 
     for (int i = 0; i < presets.size(); ++i)
         presetBox.addItem (presets[i]->name, i + 1);
@@ -103,30 +103,58 @@ private:
     juce::Slider pitchSlider, glideSlider, driveSlider, colorSlider, toneSlider;
     juce::Label  gainLabel,  attackLabel,  decayLabel,  sustainLabel,  releaseLabel;
     juce::Label  pitchLabel, glideLabel, driveLabel, colorLabel, toneLabel;
+    juce::Slider holdSlider, velocitySlider;
+    juce::Label  holdLabel,  velocityLabel;
+    juce::Slider voicesSlider, detuneSlider, spreadSlider, blendSlider, subSlider, octaveSlider;
+    juce::Label  voicesLabel,  detuneLabel,  spreadLabel,  blendLabel,  subLabel,  octaveLabel;
+    juce::Slider duckThresholdSlider, duckDepthSlider, duckAttackSlider, duckReleaseSlider;
+    juce::ComboBox duckDetectorBox;
+    juce::Label  duckThresholdLabel,  duckDepthLabel,  duckAttackLabel,  duckReleaseLabel,  duckDetectorLabel;
+    juce::Slider velDriveSlider, velToneSlider, accentAmountSlider;
+    juce::ComboBox velCurveBox, accentSourceBox;
+    juce::Label  velCurveLabel,  velDriveLabel,  velToneLabel,  accentSourceLabel,  accentAmountLabel;
     Sub808LookAndFeel lnf;
     using Attachment = juce::AudioProcessorValueTreeState::SliderAttachment;
     std::unique_ptr<Attachment> gainAttach, attackAttach, decayAttach, sustainAttach, releaseAttach;
     std::unique_ptr<Attachment> pitchAttach, glideAttach, driveAttach, colorAttach, toneAttach;
+    std::unique_ptr<Attachment> holdAttach, velocityAttach;
+    std::unique_ptr<Attachment> voicesAttach, detuneAttach, spreadAttach, blendAttach, subAttach, octaveAttach;
+    std::unique_ptr<Attachment> duckThresholdAttach, duckDepthAttach, duckAttackAttach, duckReleaseAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> duckDetectorAttach;
+    std::unique_ptr<Attachment> velDriveAttach, velToneAttach, accentAmountAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> velCurveAttach, accentSourceAttach;
 
     // Presets UI
     juce::ComboBox presetBox;
-
-    // Simple preset structure and storage
-    struct Preset {
-        juce::String name;
-        float gain;
-        float attack;
-        float decay;
-        float sustain;
-        float release;
-        float pitchSemitones; // -12..+12
-        float glideTime;      // seconds 0..0.3
-        float drive;          // 0..1
-        float color;          // -1..+1 (tilt)
-        float toneCutoff;     // Hz (normalized in processor)
-    };
-
-    juce::OwnedArray<Preset> presets;
+    juce::TextButton panicButton { "PANIC" };
+    juce::ToggleButton multirateToggle { "MULTIRATE" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> multirateAttach;
+    juce::ToggleButton kitToggle { "KIT" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> kitAttach;
+
+    // A/B morph strip
+    juce::ToggleButton morphToggle { "MORPH" };
+    juce::ComboBox morphABox, morphBBox;
+    juce::Slider morphSlider;
+    std::unique_ptr<Attachment> morphAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> morphOnAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> morphAAttach, morphBAttach;
+
+    void setupMorphStrip();
+
+    // Pattern strip
+    juce::ToggleButton patternToggle { "PATTERN" };
+    juce::ComboBox patternBox;
+    juce::Slider patternAccentSlider, patternRootSlider;
+    std::unique_ptr<Attachment> patternAccentAttach, patternRootAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> patternOnAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> patternAttach;
+
+    void setupPatternStrip();
+
+    // Factory presets live in Presets.h so the processor can morph between them
+    using Preset = Sub808Preset;
+    juce::Array<const Preset*> presets;
 
     void populatePresets();
     void loadPreset (int index);
@@ -161,11 +189,12 @@ private:
     void buildTabs();
 
     void setupSlider (juce::Slider& s);
+    void setupChoiceBox (juce::ComboBox& box, const juce::String& parameterID);
     void configureLabel (juce::Label& l, const juce::String& text);
     void setupPresetBox();
 
     void layoutKnobRow (juce::Rectangle<int> rowArea,
-                        std::initializer_list<std::pair<juce::Slider*, juce::Label*>> controls,
+                        std::initializer_list<std::pair<juce::Component*, juce::Label*>> controls,
                         int padding = 10);
 
     void setupLabel (juce::Label& l, const juce::String& text)
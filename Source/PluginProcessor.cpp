@@ -41,6 +41,16 @@ Sub808AudioProcessor::createParameterLayout()
         juce::NormalisableRange<float> (0.001f, 5.0f, 0.001f, 0.4f),
         0.15f));
 
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "hold", "Hold",
+        juce::NormalisableRange<float> (0.0f, 2.0f, 0.001f, 0.4f),
+        0.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "velocitySens", "Velocity Sensitivity",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.0f));
+
     params.push_back (std::make_unique<juce::AudioParameterFloat>(
         "pitchSemitones", "Pitch",
         juce::NormalisableRange<float> (-12.0f, 12.0f, 0.01f),
@@ -66,23 +76,210 @@ Sub808AudioProcessor::createParameterLayout()
         juce::NormalisableRange<float> (80.0f, 8000.0f, 0.01f, 0.25f),
         300.0f));
 
+    params.push_back (std::make_unique<juce::AudioParameterBool>(
+        "multirate", "Multirate", false));
+
+    params.push_back (std::make_unique<juce::AudioParameterBool>(
+        "morphOn", "Morph On", false));
+
+    params.push_back (std::make_unique<juce::AudioParameterChoice>(
+        "morphA", "Morph A", Sub808Presets::getFactoryNames(), 0));
+
+    params.push_back (std::make_unique<juce::AudioParameterChoice>(
+        "morphB", "Morph B", Sub808Presets::getFactoryNames(), 1));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "morphAmount", "Morph",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.0001f),
+        0.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterInt>(
+        "unisonVoices", "Unison Voices", 1, Sub808UnisonStack::maxUnisonVoices, 1));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "unisonDetune", "Unison Detune",
+        juce::NormalisableRange<float> (0.0f, 100.0f, 0.01f, 0.5f),
+        12.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "unisonSpread", "Unison Spread",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.5f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "unisonBlend", "Unison Blend",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.5f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "subOctave", "Sub Octave",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "octaveUp", "Octave Up",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterBool>(
+        "kitMode", "Kit Mode", false));
+
+    // Kit slots default to one note each, upwards from C1 (GM kick)
+    for (int slot = 0; slot < Sub808KitEngine::numSlots; ++slot)
+    {
+        const juce::String id   = "slot" + juce::String (slot + 1) + "_";
+        const juce::String name = "Slot " + juce::String (slot + 1) + " ";
+        const Sub808KitSlotSettings defaults;
+
+        params.push_back (std::make_unique<juce::AudioParameterInt>(
+            id + "low", name + "Low Note", 0, 127, 36 + slot));
+
+        params.push_back (std::make_unique<juce::AudioParameterInt>(
+            id + "high", name + "High Note", 0, 127, 36 + slot));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat>(
+            id + "gain", name + "Gain",
+            juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+            defaults.gain));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat>(
+            id + "tune", name + "Tune",
+            juce::NormalisableRange<float> (-24.0f, 24.0f, 0.01f),
+            defaults.tuneSemitones));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat>(
+            id + "decay", name + "Decay",
+            juce::NormalisableRange<float> (0.01f, 4.0f, 0.001f, 0.4f),
+            defaults.decay));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat>(
+            id + "drive", name + "Drive",
+            juce::NormalisableRange<float> (0.0f, 1.0f, 0.0001f),
+            defaults.drive));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat>(
+            id + "tone", name + "Tone Cutoff",
+            juce::NormalisableRange<float> (80.0f, 8000.0f, 0.01f, 0.25f),
+            defaults.toneCutoff));
+    }
+
+    params.push_back (std::make_unique<juce::AudioParameterBool>(
+        "patternOn", "Pattern On", false));
+
+    params.push_back (std::make_unique<juce::AudioParameterChoice>(
+        "pattern", "Pattern", Sub808Patterns::getFactoryNames(), 0));
+
+    params.push_back (std::make_unique<juce::AudioParameterInt>(
+        "patternRoot", "Pattern Root", 24, 60, 36));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "patternAccent", "Pattern Accent",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.3f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "duckThreshold", "Duck Threshold",
+        juce::NormalisableRange<float> (-60.0f, 0.0f, 0.1f),
+        -24.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "duckDepth", "Duck Depth",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.8f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "duckAttack", "Duck Attack",
+        juce::NormalisableRange<float> (0.1f, 50.0f, 0.01f, 0.4f),
+        1.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "duckRelease", "Duck Release",
+        juce::NormalisableRange<float> (10.0f, 1000.0f, 0.1f, 0.4f),
+        120.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterChoice>(
+        "duckDetector", "Duck Detector", juce::StringArray { "Peak", "RMS" }, 0));
+
+    // Velocity response; "velocitySens" above is its level amount
+    params.push_back (std::make_unique<juce::AudioParameterChoice>(
+        "velCurve", "Velocity Curve", Sub808VelocityDynamics::getCurveNames(), 0));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "velDrive", "Velocity To Drive",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "velTone", "Velocity To Tone",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.0f));
+
+    params.push_back (std::make_unique<juce::AudioParameterChoice>(
+        "accentSource", "Accent Source", Sub808VelocityDynamics::getAccentSourceNames(), 0));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        "accentAmount", "Accent Amount",
+        juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
+        0.3f));
+
+    params.push_back (std::make_unique<juce::AudioParameterInt>(
+        "accentThreshold", "Accent Velocity", 1, 127, 100));
+
+    params.push_back (std::make_unique<juce::AudioParameterInt>(
+        "accentCC", "Accent CC", 0, 119, 16));
+
     return { params.begin(), params.end() };
 }
 
 //==============================================================================
 
+juce::AudioProcessor::BusesProperties Sub808AudioProcessor::createBusesProperties()
+{
+    // The only input is the optional ducking sidechain. Slot 1 always plays
+    // through the main output; every other kit slot gets an optional bus of
+    // its own and falls back to the main output while that bus is disabled.
+    auto props = BusesProperties().withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
+                                  .withOutput ("Output",    juce::AudioChannelSet::stereo(), true);
+
+    for (int slot = 1; slot < Sub808KitEngine::numSlots; ++slot)
+        props = props.withOutput ("Slot " + juce::String (slot + 1), juce::AudioChannelSet::stereo(), false);
+
+    return props;
+}
+
 Sub808AudioProcessor::Sub808AudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
-    : AudioProcessor (BusesProperties()
-                      .withOutput ("Output", juce::AudioChannelSet::stereo(), true))
+    : AudioProcessor (createBusesProperties())
 #else
     : AudioProcessor()
 #endif
     , apvts (*this, nullptr, "PARAMS", createParameterLayout())
 {
+    for (int slot = 0; slot < Sub808KitEngine::numSlots; ++slot)
+    {
+        const juce::String id = "slot" + juce::String (slot + 1) + "_";
+        auto& p = kitParams[slot];
+
+        p.low   = apvts.getRawParameterValue (id + "low");
+        p.high  = apvts.getRawParameterValue (id + "high");
+        p.gain  = apvts.getRawParameterValue (id + "gain");
+        p.tune  = apvts.getRawParameterValue (id + "tune");
+        p.decay = apvts.getRawParameterValue (id + "decay");
+        p.drive = apvts.getRawParameterValue (id + "drive");
+        p.tone  = apvts.getRawParameterValue (id + "tone");
+    }
+
+    updatePatternTimeline();
+
+    // Frees whatever the audio thread hands back through the command queue
+    startTimerHz (10);
 }
 
-Sub808AudioProcessor::~Sub808AudioProcessor() = default;
+Sub808AudioProcessor::~Sub808AudioProcessor()
+{
+    stopTimer();
+    delete patternTimeline;
+}
 
 //==============================================================================
 
@@ -150,17 +347,38 @@ void Sub808AudioProcessor::changeProgramName (int /*index*/, const juce::String&
 
 void Sub808AudioProcessor::prepareToPlay (double newSampleRate, int /*samplesPerBlock*/)
 {
+    Sub808Dsp::initialise();
+
     sampleRateHz = newSampleRate;
-    phase = 0.0f;
-    phaseDelta = 0.0f;
+    coreFactor   = 1;
+    coreRateHz   = sampleRateHz;
+
+    unison.prepare (sampleRateHz);
+    morph.prepare (sampleRateHz);
+
+    envelope.setSampleRate (sampleRateHz);
+    envelope.setParameters ({});
+
+    kit.prepare (sampleRateHz);
+    ducker.prepare (sampleRateHz);
+
+    for (auto& u : upsamplers)
+        u.prepare (coreFactor);
 
-    adsr.setSampleRate (sampleRateHz);
+    resetEngineState();
+    updateLatency();
+}
 
-    adsrParams.attack  = 0.005f;
-    adsrParams.decay   = 0.05f;
-    adsrParams.sustain = 0.8f;
-    adsrParams.release = 0.15f;
-    adsr.setParameters (adsrParams);
+void Sub808AudioProcessor::resetEngineState()
+{
+    unison.reset();
+    envelope.reset();
+    kit.reset();
+    sequencer.reset();
+    ducker.reset();
+    dynamics.reset();
+    noteDynamics = {};
+    noteDriveToneStale = true;
 
     currentFreq = 0.0f;
     targetFreq  = 0.0f;
@@ -168,6 +386,73 @@ void Sub808AudioProcessor::prepareToPlay (double newSampleRate, int /*samplesPer
 
     for (int ch = 0; ch < 2; ++ch)
         toneZ[ch] = 0.0f;
+
+    for (auto& u : upsamplers)
+        u.reset();
+
+    numCoreLeftover = 0;
+}
+
+//==============================================================================
+// The queue only fills up if the audio thread hasn't drained it for a while
+// (e.g. a host that stops calling processBlock); timerCallback() retries.
+void Sub808AudioProcessor::sendPanic()
+{
+    panicPending = ! commands.post (Sub808EngineCommand::Type::panic);
+}
+
+void Sub808AudioProcessor::sendResetState()
+{
+    resetStatePending = ! commands.post (Sub808EngineCommand::Type::resetState);
+}
+
+void Sub808AudioProcessor::handleCommand (const Sub808EngineCommand& cmd)
+{
+    switch (cmd.type)
+    {
+        case Sub808EngineCommand::Type::panic:
+            envelope.reset();
+            kit.reset();
+            glideSamplesRemaining = 0;
+            break;
+
+        case Sub808EngineCommand::Type::resetState:
+            resetEngineState();
+            break;
+
+        case Sub808EngineCommand::Type::swapResource:
+            break; // applied by the queue itself
+    }
+}
+
+void Sub808AudioProcessor::timerCallback()
+{
+    commands.collectGarbage();
+
+    if (resetStatePending)
+        sendResetState();
+
+    if (panicPending)
+        sendPanic();
+
+    updatePatternTimeline();
+    updateLatency();
+}
+
+void Sub808AudioProcessor::updatePatternTimeline()
+{
+    const int index = juce::jlimit (0, Sub808Patterns::numFactory - 1, (int) apvts.getRawParameterValue ("pattern")->load());
+    const int root  = (int) apvts.getRawParameterValue ("patternRoot")->load();
+
+    if (index == compiledPattern && root == compiledRoot)
+        return;
+
+    // If the queue happens to be full this is simply retried on the next tick
+    if (commands.swapResource (patternTimeline, Sub808PatternTimeline::compile (Sub808Patterns::factory[index], root)))
+    {
+        compiledPattern = index;
+        compiledRoot    = root;
+    }
 }
 
 void Sub808AudioProcessor::releaseResources()
@@ -187,6 +472,22 @@ bool Sub808AudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) c
      && mainOut != juce::AudioChannelSet::stereo())
         return false;
 
+    // Kit slot outputs and the sidechain input: each one off, mono or stereo
+    auto isOptionalBusSupported = [] (const juce::AudioChannelSet& set)
+    {
+        return set.isDisabled()
+            || set == juce::AudioChannelSet::mono()
+            || set == juce::AudioChannelSet::stereo();
+    };
+
+    for (int bus = 1; bus < layouts.getBusCount (false); ++bus)
+        if (! isOptionalBusSupported (layouts.getChannelSet (false, bus)))
+            return false;
+
+    for (int bus = 0; bus < layouts.getBusCount (true); ++bus)
+        if (! isOptionalBusSupported (layouts.getChannelSet (true, bus)))
+            return false;
+
    #if ! JucePlugin_IsSynth
     // If not a synth, require matching input/output layouts
     if (mainOut != layouts.getMainInputChannelSet())
@@ -203,72 +504,465 @@ void Sub808AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
 {
     juce::ScopedNoDenormals noDenormals;
 
-    const float gain    = apvts.getRawParameterValue ("gain")->load();
-    const float attack  = apvts.getRawParameterValue ("attack")->load();
-    const float decay   = apvts.getRawParameterValue ("decay")->load();
-    const float sustain = apvts.getRawParameterValue ("sustain")->load();
-    const float release = apvts.getRawParameterValue ("release")->load();
+    commands.drain ([this] (const Sub808EngineCommand& cmd) { handleCommand (cmd); });
 
-    const float pitchSemis = apvts.getRawParameterValue ("pitchSemitones")->load();
-    const float glideSec   = apvts.getRawParameterValue ("glideTime")->load();
-    const float driveAmt   = apvts.getRawParameterValue ("drive")->load();
-    const float colorAmt   = apvts.getRawParameterValue ("color")->load();
-    const float toneHz     = apvts.getRawParameterValue ("toneCutoff")->load();
+    Sub808VoiceSettings settings;
 
-    juce::ADSR::Parameters p;
-    p.attack  = attack;
-    p.decay   = decay;
-    p.sustain = sustain;
-    p.release = release;
-    adsr.setParameters (p);
+    const bool morphOn      = apvts.getRawParameterValue ("morphOn")->load() > 0.5f;
+    const float morphAmount = apvts.getRawParameterValue ("morphAmount")->load();
 
-    const float toneAlpha = juce::jlimit (0.0f, 1.0f, (float) std::exp (-2.0f * juce::MathConstants<float>::pi * toneHz / (float) sampleRateHz));
+    if (morphOn)
+    {
+        morph.setPresets ((int) apvts.getRawParameterValue ("morphA")->load(),
+                          (int) apvts.getRawParameterValue ("morphB")->load());
+        morph.setTarget (morphAmount);
+        settings = morph.getCurrent();
+    }
+    else
+    {
+        const Sub808Preset values { nullptr,
+                                    apvts.getRawParameterValue ("gain")->load(),
+                                    apvts.getRawParameterValue ("attack")->load(),
+                                    apvts.getRawParameterValue ("decay")->load(),
+                                    apvts.getRawParameterValue ("sustain")->load(),
+                                    apvts.getRawParameterValue ("release")->load(),
+                                    apvts.getRawParameterValue ("pitchSemitones")->load(),
+                                    apvts.getRawParameterValue ("glideTime")->load(),
+                                    apvts.getRawParameterValue ("drive")->load(),
+                                    apvts.getRawParameterValue ("color")->load(),
+                                    apvts.getRawParameterValue ("toneCutoff")->load() };
+
+        settings = Sub808VoiceSettings::fromValues (values, sampleRateHz);
+        morph.jumpTo (morphAmount); // so switching the morph on doesn't sweep from a stale position
+    }
 
-    const int numSamples  = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
+    unison.setParameters ((int) apvts.getRawParameterValue ("unisonVoices")->load(),
+                          apvts.getRawParameterValue ("unisonDetune")->load(),
+                          apvts.getRawParameterValue ("unisonSpread")->load(),
+                          apvts.getRawParameterValue ("unisonBlend")->load(),
+                          apvts.getRawParameterValue ("subOctave")->load(),
+                          apvts.getRawParameterValue ("octaveUp")->load());
 
-    buffer.clear();
+    holdTime = apvts.getRawParameterValue ("hold")->load();
+    updateDynamics();
 
-    for (const auto metadata : midiMessages)
+    applyEnvelopeSettings (settings);
+
+    const bool multirateOn = apvts.getRawParameterValue ("multirate")->load() > 0.5f;
+    setCoreFactor (multirateOn ? getMultirateFactor (sampleRateHz) : 1);
+
+    const bool kitOn = apvts.getRawParameterValue ("kitMode")->load() > 0.5f;
+
+    if (kitOn != kitModeActive)
+    {
+        // Don't leave the other engine hanging mid-note
+        resetEngineState();
+        kitModeActive = kitOn;
+    }
+
+    if (kitOn)
+        updateKitSlots();
+
+    const int numSamples = buffer.getNumSamples();
+
+    // Sidechain detection comes first: the input channels share the buffer
+    // with the outputs and are gone once it has been cleared.
     {
-        const auto msg = metadata.getMessage();
+        ducker.setParameters ({ apvts.getRawParameterValue ("duckThreshold")->load(),
+                                apvts.getRawParameterValue ("duckDepth")->load(),
+                                apvts.getRawParameterValue ("duckAttack")->load(),
+                                apvts.getRawParameterValue ("duckRelease")->load(),
+                                apvts.getRawParameterValue ("duckDetector")->load() > 0.5f });
+
+        const float* sidechain[2] {};
+        int numSidechain = 0;
 
-        if (msg.isNoteOn())
+        if (getBusCount (true) > 0)
         {
-            const float base = (float) juce::MidiMessage::getMidiNoteInHertz (msg.getNoteNumber());
-            const float detune = std::pow (2.0f, pitchSemis / 12.0f);
-            const float newTarget = base * detune;
-
-            targetFreq = newTarget;
-
-            if (glideSec > 0.0f && currentFreq > 0.0f)
-            {
-                glideSamplesRemaining = (int) (juce::jlimit (0.0f, 10.0f, glideSec) * (float) sampleRateHz);
-                if (glideSamplesRemaining <= 0)
-                {
-                    currentFreq = targetFreq;
-                    phaseDelta = juce::MathConstants<float>::twoPi * currentFreq / (float) sampleRateHz;
-                }
-            }
-            else
-            {
-                currentFreq = targetFreq;
-                phaseDelta = juce::MathConstants<float>::twoPi * currentFreq / (float) sampleRateHz;
-            }
-
-            adsr.noteOn();
+            const int first = getChannelIndexInProcessBlockBuffer (true, 0, 0);
+            numSidechain = juce::jlimit (0, 2, juce::jmin (getBus (true, 0)->getNumberOfChannels(),
+                                                           buffer.getNumChannels() - first));
+
+            for (int ch = 0; ch < numSidechain; ++ch)
+                sidechain[ch] = buffer.getReadPointer (first + ch);
         }
-        else if (msg.isNoteOff())
+
+        ducker.analyse (Sub808Dsp::getKernels(), sidechain, numSidechain, numSamples);
+    }
+
+    buffer.clear();
+
+    if (buffer.getNumChannels() == 0)
+        return;
+
+    // Internal pattern: the events of the compiled timeline due in this block
+    juce::Optional<juce::AudioPlayHead::PositionInfo> hostPosition;
+
+    if (auto* playHead = getPlayHead())
+        hostPosition = playHead->getPosition();
+
+    const bool patternOn = apvts.getRawParameterValue ("patternOn")->load() > 0.5f;
+
+    Sub808PatternSequencer::Event patternEvents[Sub808PatternSequencer::maxEventsPerBlock];
+    const int numPatternEvents = sequencer.process (patternOn ? static_cast<const Sub808PatternTimeline*> (patternTimeline) : nullptr,
+                                                    hostPosition.hasValue() ? &*hostPosition : nullptr,
+                                                    sampleRateHz, numSamples, patternEvents);
+    int nextPatternEvent = 0;
+
+    // Render up to each MIDI or pattern event, then apply it, so bursts of
+    // notes and all-notes-off inside one block land on the right sample. Hosts
+    // occasionally send positions outside the block; clamp those to its edges.
+    int position = 0;
+
+    auto renderUpTo = [&] (int eventPosition)
+    {
+        eventPosition = juce::jlimit (position, numSamples, eventPosition);
+
+        if (kitOn)
+            renderKitRange (buffer, position, eventPosition, settings.gain);
+        else
+            renderRange (buffer, position, eventPosition, settings, morphOn);
+
+        position = eventPosition;
+    };
+
+    // Pattern events go first when they land on the same sample as MIDI
+    auto playPatternUpTo = [&] (int eventPosition)
+    {
+        for (; nextPatternEvent < numPatternEvents && patternEvents[nextPatternEvent].samplePosition <= eventPosition; ++nextPatternEvent)
         {
-            adsr.noteOff();
+            renderUpTo (patternEvents[nextPatternEvent].samplePosition);
+            handlePatternEvent (patternEvents[nextPatternEvent], settings, kitOn);
         }
-        else if (msg.isAllNotesOff() || msg.isAllSoundOff())
+    };
+
+    for (const auto metadata : midiMessages)
+    {
+        playPatternUpTo (metadata.samplePosition);
+        renderUpTo (metadata.samplePosition);
+
+        if (kitOn)
+            handleKitMidiMessage (metadata.getMessage());
+        else
+            handleMidiMessage (metadata.getMessage(), settings);
+    }
+
+    playPatternUpTo (numSamples);
+    renderUpTo (numSamples);
+
+    // A non-finite sample or filter state means the whole block is garbage;
+    // start over rather than keep feeding NaNs to the host.
+    if (! isOutputFinite (buffer, numSamples))
+    {
+        resetEngineState();
+        buffer.clear();
+    }
+
+    // Kick ducking, on every output bus
+    ducker.apply (buffer, numSamples);
+
+    // The tone filter decays towards zero forever; keep it out of denormals
+    // even on hosts/CPUs where ScopedNoDenormals has no effect.
+    for (auto& z : toneZ)
+        JUCE_SNAP_TO_ZERO (z);
+}
+
+bool Sub808AudioProcessor::isOutputFinite (const juce::AudioBuffer<float>& buffer, int numSamples) const
+{
+    if (! std::isfinite (toneZ[0]) || ! std::isfinite (toneZ[1]) || ! kit.isFinite())
+        return false;
+
+    // Every output channel, kit buses included. One NaN or Inf anywhere makes
+    // the sum of squares non-finite, so a single vectorised pass finds it.
+    const auto& kernels = Sub808Dsp::getKernels();
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        float peak = 0.0f, sumSquares = 0.0f;
+        kernels.levelDetect (buffer.getReadPointer (ch), numSamples, peak, sumSquares);
+
+        if (! std::isfinite (sumSquares))
+            return false;
+    }
+
+    return true;
+}
+
+void Sub808AudioProcessor::startNote (int noteNumber, const Sub808NoteDynamics& note, bool slide, const Sub808VoiceSettings& settings)
+{
+    const float base = (float) juce::MidiMessage::getMidiNoteInHertz (noteNumber);
+    const float newTarget = base * settings.pitchRatio;
+
+    targetFreq = newTarget;
+
+    // A slide always glides, even with the glide knob at zero
+    const float glideTime = slide ? juce::jmax (settings.glideTime, slideTime) : settings.glideTime;
+
+    if (glideTime > 0.0f && currentFreq > 0.0f)
+    {
+        glideSamplesRemaining = (int) (juce::jlimit (0.0f, 10.0f, glideTime) * (float) coreRateHz);
+        if (glideSamplesRemaining <= 0)
+            currentFreq = targetFreq;
+    }
+    else
+    {
+        currentFreq = targetFreq;
+    }
+
+    // Drive and tone follow the new note from here on, even on a slide
+    noteDynamics = note;
+    noteDriveToneStale = true;
+    updateNoteDriveTone (settings);
+
+    // ...and doesn't retrigger a note that is still sounding
+    if (! (slide && envelope.isActive()))
+        envelope.noteOn (note.level);
+}
+
+void Sub808AudioProcessor::handlePatternEvent (const Sub808PatternSequencer::Event& e,
+                                               const Sub808VoiceSettings& settings, bool kitOn)
+{
+    const auto note = dynamics.getPatternNote (e.accent);
+
+    if (e.note == Sub808PatternEvent::noteOff)
+    {
+        if (! kitOn) // kit slots are one-shots
+            envelope.noteOff();
+    }
+    else if (kitOn)
+    {
+        const int slot = kit.findSlot (e.note);
+
+        if (slot >= 0)
+            kit.noteOn (slot, e.note, note);
+    }
+    else
+    {
+        startNote (e.note, note, e.slide, settings);
+    }
+}
+
+void Sub808AudioProcessor::handleMidiMessage (const juce::MidiMessage& msg, const Sub808VoiceSettings& settings)
+{
+    if (msg.isNoteOn())
+    {
+        startNote (msg.getNoteNumber(), dynamics.getNote (msg.getVelocity()), false, settings);
+    }
+    else if (msg.isNoteOff())
+    {
+        envelope.noteOff();
+    }
+    else if (msg.isAllNotesOff() || msg.isAllSoundOff())
+    {
+        // Channel mode messages are controllers (123 / 120) too, so check them first
+        envelope.reset();
+        glideSamplesRemaining = 0;
+    }
+    else if (msg.isController())
+    {
+        dynamics.handleController (msg.getControllerNumber(), msg.getControllerValue());
+    }
+}
+
+void Sub808AudioProcessor::renderRange (juce::AudioBuffer<float>& buffer, int startSample, int endSample,
+                                        Sub808VoiceSettings& settings, bool morphOn)
+{
+    // Only the main bus; any kit slot buses follow it in the buffer
+    const int numChannels = juce::jmin (buffer.getNumChannels(), getMainBusNumOutputChannels());
+    const auto& kernels = Sub808Dsp::getKernels();
+
+    for (int start = startSample; start < endSample;)
+    {
+        // While the morph knob is moving, step the coefficients at control rate.
+        // The envelope times only follow at block rate (processBlock): every
+        // change re-times the running stage, and 16 samples is far finer than
+        // a timing change can be heard.
+        const bool morphing = morphOn && morph.isMoving();
+        const int n = juce::jmin (morphing ? morphControlInterval : maxChunkSize, endSample - start);
+
+        if (morphing)
+            settings = morph.advance (n);
+
+        // The knob settings with the sounding note's velocity / accent response
+        updateNoteDriveTone (settings);
+        const auto& driveTone = noteDriveTone;
+
+        alignas (64) float stereo[2][maxChunkSize];
+
+        // Enveloped oscillator stack, at the core rate and brought up to the host rate
+        renderSubCore (kernels, stereo[0], stereo[1], n);
+
+        if (numChannels == 1)
+            for (int i = 0; i < n; ++i)
+                stereo[0][i] = 0.5f * (stereo[0][i] + stereo[1][i]);
+
+        // Wideband stages stay at the host rate
+        for (int ch = 0; ch < juce::jmin (numChannels, 2); ++ch)
         {
-            adsr.reset();
+            float* s = stereo[ch];
+
+            // Soft saturation (drive)
+            if (driveTone.driveK > 0.0f)
+                kernels.drive (s, n, driveTone.driveK, driveTone.driveNorm);
+
+            // Color + one-pole low-pass tone filter per channel
+            kernels.toneFilter (s, n, toneZ[ch], driveTone.toneFeedback, driveTone.toneInputGain);
+
+            kernels.fanOut (buffer.getWritePointer (ch, start), s, settings.gain, n);
         }
+
+        start += n;
+    }
+}
+
+//==============================================================================
+void Sub808AudioProcessor::updateDynamics()
+{
+    Sub808VelocityDynamics::Parameters p;
+    p.curve       = (Sub808VelocityDynamics::Curve) (int) apvts.getRawParameterValue ("velCurve")->load();
+    p.levelAmount = apvts.getRawParameterValue ("velocitySens")->load();
+    p.driveAmount = apvts.getRawParameterValue ("velDrive")->load();
+    p.toneAmount  = apvts.getRawParameterValue ("velTone")->load();
+
+    p.accentSource        = (Sub808VelocityDynamics::AccentSource) (int) apvts.getRawParameterValue ("accentSource")->load();
+    p.accentThreshold     = (int) apvts.getRawParameterValue ("accentThreshold")->load();
+    p.accentController    = (int) apvts.getRawParameterValue ("accentCC")->load();
+    p.accentAmount        = apvts.getRawParameterValue ("accentAmount")->load();
+    p.patternAccentAmount = apvts.getRawParameterValue ("patternAccent")->load();
+
+    dynamics.setParameters (p);
+}
+
+//==============================================================================
+void Sub808AudioProcessor::updateKitSlots()
+{
+    for (int slot = 0; slot < Sub808KitEngine::numSlots; ++slot)
+    {
+        const auto& p = kitParams[slot];
+
+        Sub808KitSlotSettings s;
+        s.lowNote       = (int) p.low->load();
+        s.highNote      = (int) p.high->load();
+        s.gain          = p.gain->load();
+        s.tuneSemitones = p.tune->load();
+        s.decay         = p.decay->load();
+        s.drive         = p.drive->load();
+        s.toneCutoff    = p.tone->load();
+
+        kit.setSlot (slot, s);
+    }
+}
+
+void Sub808AudioProcessor::handleKitMidiMessage (const juce::MidiMessage& msg)
+{
+    // Kit slots are one-shots, so note-offs are ignored like on the hardware
+    if (msg.isNoteOn())
+    {
+        const int slot = kit.findSlot (msg.getNoteNumber());
+
+        if (slot >= 0)
+            kit.noteOn (slot, msg.getNoteNumber(), dynamics.getNote (msg.getVelocity()));
+    }
+    else if (msg.isAllNotesOff() || msg.isAllSoundOff())
+    {
+        kit.reset();
+    }
+    else if (msg.isController())
+    {
+        dynamics.handleController (msg.getControllerNumber(), msg.getControllerValue());
+    }
+}
+
+juce::AudioBuffer<float> Sub808AudioProcessor::getKitSlotOutput (juce::AudioBuffer<float>& buffer, int slot)
+{
+    // The slot's own bus if it is enabled, otherwise the main output
+    for (const int bus : { slot, 0 })
+    {
+        if (bus >= getBusCount (false))
+            continue;
+
+        const int first = getChannelIndexInProcessBlockBuffer (false, bus, 0);
+        const int count = juce::jmin (getBus (false, bus)->getNumberOfChannels(), buffer.getNumChannels() - first);
+
+        if (count > 0)
+            return { buffer.getArrayOfWritePointers() + first, count, buffer.getNumSamples() };
+    }
+
+    return {};
+}
+
+void Sub808AudioProcessor::renderKitRange (juce::AudioBuffer<float>& buffer, int startSample, int endSample, float gain)
+{
+    const auto& kernels = Sub808Dsp::getKernels();
+
+    for (int start = startSample; start < endSample;)
+    {
+        const int n = juce::jmin ((int) Sub808KitEngine::maxRenderSize, endSample - start);
+
+        kit.render (kernels, n, [&] (int slot, const float* samples, int numSamples)
+        {
+            auto out = getKitSlotOutput (buffer, slot);
+
+            for (int ch = 0; ch < out.getNumChannels(); ++ch)
+                juce::FloatVectorOperations::addWithMultiply (out.getWritePointer (ch, start), samples, gain, numSamples);
+        });
+
+        start += n;
+    }
+}
+
+//==============================================================================
+void Sub808AudioProcessor::renderSubCore (const Sub808Dsp::KernelTable& kernels,
+                                          float* left, float* right, int numSamples)
+{
+    if (coreFactor == 1)
+    {
+        renderCoreSamples (kernels, left, right, numSamples);
+        return;
     }
 
-    for (int sample = 0; sample < numSamples; ++sample)
+    float* out[2] { left, right };
+
+    // Samples left over from the last interpolated core sample
+    const int fromLeftover = juce::jmin (numCoreLeftover, numSamples);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        std::copy (coreLeftover[ch], coreLeftover[ch] + fromLeftover, out[ch]);
+        std::copy (coreLeftover[ch] + fromLeftover, coreLeftover[ch] + numCoreLeftover, coreLeftover[ch]);
+    }
+
+    numCoreLeftover -= fromLeftover;
+
+    const int needed = numSamples - fromLeftover;
+
+    if (needed <= 0)
+        return;
+
+    const int numCore = (needed + coreFactor - 1) / coreFactor;
+
+    alignas (64) float core[2][maxChunkSize];
+    alignas (64) float upsampled[maxChunkSize + Sub808PolyphaseUpsampler::maxFactor];
+
+    renderCoreSamples (kernels, core[0], core[1], numCore);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        upsamplers[ch].process (core[ch], upsampled, numCore);
+        std::copy (upsampled, upsampled + needed, out[ch] + fromLeftover);
+        std::copy (upsampled + needed, upsampled + numCore * coreFactor, coreLeftover[ch]);
+    }
+
+    numCoreLeftover = numCore * coreFactor - needed;
+}
+
+void Sub808AudioProcessor::renderCoreSamples (const Sub808Dsp::KernelTable& kernels,
+                                              float* left, float* right, int numSamples)
+{
+    alignas (64) float freq[maxChunkSize];
+    alignas (64) float env[maxChunkSize];
+
+    for (int i = 0; i < numSamples; ++i)
     {
         // Glide toward target frequency
         if (glideSamplesRemaining > 0)
@@ -276,42 +970,88 @@ void Sub808AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
             const float step = (targetFreq - currentFreq) / (float) glideSamplesRemaining;
             currentFreq += step;
             --glideSamplesRemaining;
-            phaseDelta = juce::MathConstants<float>::twoPi * currentFreq / (float) sampleRateHz;
         }
 
-        const float env = adsr.getNextSample();
-        float s = std::sin (phase) * env;
+        freq[i] = currentFreq;
+    }
 
-        // Soft saturation (drive): arctangent waveshaper
-        if (driveAmt > 0.0f)
-        {
-            const float k = juce::jmap (driveAmt, 0.0f, 1.0f, 0.0f, 2.5f);
-            s = std::tanh (k * s) / (k > 0.0f ? std::tanh (k) : 1.0f);
-        }
+    // Idle fast path: nothing to hear, so skip the oscillator stack entirely
+    if (! envelope.isActive())
+    {
+        std::fill (left,  left  + numSamples, 0.0f);
+        std::fill (right, right + numSamples, 0.0f);
+        return;
+    }
 
-        // Simple tilt EQ (color): brighten (positive) or warm (negative)
-        // Apply as pre-emphasis/de-emphasis using a simple high-shelf approximation
-        float low = s;
-        float high = s - toneZ[0]; // crude high-passed component based on previous low (mono ref)
-        s = s + high * colorAmt * 0.5f - low * (-colorAmt) * 0.5f;
+    envelope.process (kernels, env, numSamples);
 
-        // One-pole low-pass tone filter per channel later when writing
+    // Unison / sub / octave stack, already spread across left and right
+    unison.renderBlock (kernels, freq, left, right, numSamples);
 
-        phase += phaseDelta;
-        if (phase >= juce::MathConstants<float>::twoPi)
-            phase -= juce::MathConstants<float>::twoPi;
+    kernels.envelope (left,  env, numSamples);
+    kernels.envelope (right, env, numSamples);
+}
 
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            // Apply tone LPF per channel
-            float z = toneZ[ch];
-            z = toneAlpha * z + (1.0f - toneAlpha) * s;
-            toneZ[ch] = z;
+int Sub808AudioProcessor::getMultirateFactor (double hostRate)
+{
+    // Largest power of two that keeps the core at 44.1 kHz or above, so the
+    // whole audible band of the oscillator stack survives.
+    int factor = 1;
 
-            const float out = z * gain;
-            buffer.setSample (ch, sample, out);
-        }
-    }
+    while (factor < Sub808PolyphaseUpsampler::maxFactor && hostRate / (factor * 2) >= 44100.0)
+        factor *= 2;
+
+    return factor;
+}
+
+void Sub808AudioProcessor::setCoreFactor (int newFactor)
+{
+    if (newFactor == coreFactor)
+        return;
+
+    // Keep an in-progress glide the same length in seconds
+    glideSamplesRemaining = glideSamplesRemaining * coreFactor / newFactor;
+
+    coreFactor = newFactor;
+    coreRateHz = sampleRateHz / coreFactor;
+
+    unison.setSampleRate (coreRateHz);
+    envelope.setSampleRate (coreRateHz);
+
+    for (auto& u : upsamplers)
+        u.prepare (coreFactor);
+
+    numCoreLeftover = 0;
+}
+
+void Sub808AudioProcessor::updateLatency()
+{
+    // Kit mode renders at the host rate, so only the mono voice is delayed
+    const bool multirateOn = apvts.getRawParameterValue ("multirate")->load() > 0.5f;
+    const bool kitOn       = apvts.getRawParameterValue ("kitMode")->load() > 0.5f;
+
+    const int latency = multirateOn && ! kitOn
+                          ? Sub808PolyphaseUpsampler::getLatencyInSamples (getMultirateFactor (sampleRateHz))
+                          : 0;
+
+    if (latency != getLatencySamples())
+        setLatencySamples (latency);
+}
+
+void Sub808AudioProcessor::updateNoteDriveTone (const Sub808VoiceSettings& settings) noexcept
+{
+    if (! noteDriveToneStale && ! settings.driveToneDiffers (noteDriveToneSettings))
+        return;
+
+    noteDriveTone = settings.getDriveTone (noteDynamics);
+    noteDriveToneSettings = settings;
+    noteDriveToneStale = false;
+}
+
+void Sub808AudioProcessor::applyEnvelopeSettings (const Sub808VoiceSettings& settings)
+{
+    // Sub808Envelope ignores unchanged parameters, and ones the running stage doesn't use, itself
+    envelope.setParameters ({ settings.attack, holdTime, settings.decay, settings.sustain, settings.release });
 }
 
 //==============================================================================
@@ -10,10 +10,20 @@
 
 #include <JuceHeader.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "UnisonStack.h"
+#include "PresetMorph.h"
+#include "EngineCommands.h"
+#include "PolyphaseUpsampler.h"
+#include "Envelope.h"
+#include "KitEngine.h"
+#include "PatternEngine.h"
+#include "SidechainDucker.h"
+#include "VelocityDynamics.h"
 //==============================================================================
 /**
 */
-class Sub808AudioProcessor  : public juce::AudioProcessor
+class Sub808AudioProcessor  : public juce::AudioProcessor,
+                              private juce::Timer
 {
 public:
     //==============================================================================
@@ -55,14 +65,110 @@ public:
     //==============================================================================
     juce::AudioProcessorValueTreeState apvts;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    //==============================================================================
+    // Message thread -> audio thread actions (see EngineCommands.h)
+    void sendPanic();
+    void sendResetState();
+    Sub808CommandQueue& getCommandQueue() noexcept { return commands; }
 private:
     //==============================================================================
     
+    // processBlock renders in chunks of at most this many samples so its
+    // scratch buffers can live on the stack whatever block size the host uses.
+    static constexpr int maxChunkSize = 128;
+
+    // Coefficient update interval while the A/B morph is being moved.
+    static constexpr int morphControlInterval = 16;
+
+    void applyEnvelopeSettings (const Sub808VoiceSettings& settings);
+    void handleMidiMessage (const juce::MidiMessage& msg, const Sub808VoiceSettings& settings);
+    void renderRange (juce::AudioBuffer<float>& buffer, int startSample, int endSample,
+                      Sub808VoiceSettings& settings, bool morphOn);
+
+    // Multirate sub engine: the oscillator stack and envelope (the "core") run
+    // at sampleRateHz / coreFactor and are interpolated back up to the host
+    // rate; drive, color and tone always run at the host rate.
+    void renderSubCore (const Sub808Dsp::KernelTable& kernels, float* left, float* right, int numSamples);
+    void renderCoreSamples (const Sub808Dsp::KernelTable& kernels, float* left, float* right, int numSamples);
+    void setCoreFactor (int newFactor);
+    static int getMultirateFactor (double hostRate);
+
+    // The interpolator delays the sub voice by its group delay; reported to
+    // the host from the message thread whenever multirate or kit mode flips.
+    void updateLatency();
+
+    int    coreFactor = 1;
+    double coreRateHz = 44100.0;
+    Sub808PolyphaseUpsampler upsamplers[2];
+    float coreLeftover[2][Sub808PolyphaseUpsampler::maxFactor] {};
+    int   numCoreLeftover = 0;
+
+    // Drum-kit mode (see KitEngine.h): note ranges to independent slots, each
+    // with its own parameters and, optionally, its own output bus.
+    static BusesProperties createBusesProperties();
+    void updateKitSlots();
+    void handleKitMidiMessage (const juce::MidiMessage& msg);
+    void renderKitRange (juce::AudioBuffer<float>& buffer, int startSample, int endSample, float gain);
+    juce::AudioBuffer<float> getKitSlotOutput (juce::AudioBuffer<float>& buffer, int slot);
+
+    struct KitSlotParameters
+    {
+        std::atomic<float>* low   = nullptr;
+        std::atomic<float>* high  = nullptr;
+        std::atomic<float>* gain  = nullptr;
+        std::atomic<float>* tune  = nullptr;
+        std::atomic<float>* decay = nullptr;
+        std::atomic<float>* drive = nullptr;
+        std::atomic<float>* tone  = nullptr;
+    };
+
+    KitSlotParameters kitParams[Sub808KitEngine::numSlots];
+    Sub808KitEngine kit;
+    bool kitModeActive = false;
+
+    // Host-synced pattern engine (see PatternEngine.h)
+    static constexpr float slideTime = 0.06f; // seconds, when the glide knob is at zero
+
+    void updatePatternTimeline();
+    void startNote (int noteNumber, const Sub808NoteDynamics& note, bool slide, const Sub808VoiceSettings& settings);
+    void handlePatternEvent (const Sub808PatternSequencer::Event& e, const Sub808VoiceSettings& settings, bool kitOn);
+
+    Sub808EngineResource* patternTimeline = nullptr; // owned, replaced through the command queue
+    Sub808PatternSequencer sequencer;
+    int   compiledPattern = -1, compiledRoot = -1; // message thread
+
+    // Kick ducking from the optional sidechain input (see SidechainDucker.h)
+    Sub808SidechainDucker ducker;
+
+    // Velocity / accent response (see VelocityDynamics.h), and that of the
+    // note the mono voice is playing
+    void updateDynamics();
+
+    Sub808VelocityDynamics dynamics;
+    Sub808NoteDynamics noteDynamics;
+
+    // The sounding note's drive / tone coefficients, and the settings they
+    // were made from; only recomputed when either changes
+    void updateNoteDriveTone (const Sub808VoiceSettings& settings) noexcept;
+
+    Sub808DriveToneCoefficients noteDriveTone {};
+    Sub808VoiceSettings noteDriveToneSettings {};
+    bool noteDriveToneStale = true;
+
+    void resetEngineState();
+    bool isOutputFinite (const juce::AudioBuffer<float>& buffer, int numSamples) const;
+    void handleCommand (const Sub808EngineCommand& cmd);
+    void timerCallback() override;
+
+    Sub808CommandQueue commands;
+    bool panicPending = false, resetStatePending = false; // message thread; posting failed, retry
+
     double sampleRateHz = 44100.0;
-    float phase = 0.0f;
-    float phaseDelta = 0.0f;
-    juce::ADSR adsr;
-    juce::ADSR::Parameters adsrParams;
+    Sub808UnisonStack unison;
+    Sub808PresetMorph morph;
+    Sub808Envelope envelope;
+    float holdTime = 0.0f;
     // New DSP state for pitch/glide/tone
     float currentFreq = 0.0f;
     float targetFreq  = 0.0f;
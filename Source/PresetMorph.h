@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    PresetMorph.h
+    A/B morph between two factory presets, cheap enough to ride under
+    constant host automation.
+
+    When the pair of presets changes, the per-parameter deltas (B - A) are
+    taken once and every derived DSP coefficient (pitch ratio, drive
+    normalisation, tone filter poles...) is baked into a small curve over
+    the morph position. While the morph knob moves, the audio thread only
+    smooths the position and linearly interpolates between two curve
+    points; no exp/tanh/pow is evaluated.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Presets.h"
+#include "FastMath.h"
+#include "VelocityDynamics.h"
+
+/** The ten preset parameters, already turned into the coefficients the
+    render loop uses. */
+struct Sub808VoiceSettings
+{
+    float gain;
+    float attack, decay, sustain, release;
+    float pitchRatio;    // 2 ^ (pitchSemitones / 12)
+    float glideTime;
+    float driveK;        // tanh pre-gain, 0 = drive off
+    float driveNorm;     // 1 / tanh (driveK)
+    float toneFeedback;  // color tilt folded into the one-pole tone filter
+    float toneInputGain;
+    float toneOmega;     // 2 * pi * toneCutoff / sampleRate
+    float color;
+
+    /** The drive and tone coefficients for a note with the given dynamics. */
+    Sub808DriveToneCoefficients getDriveTone (const Sub808NoteDynamics& note) const noexcept
+    {
+        if (juce::exactlyEqual (note.driveScale, 1.0f) && juce::exactlyEqual (note.toneRatio, 1.0f))
+            return { driveK, driveNorm, toneFeedback, toneInputGain };
+
+        return Sub808DriveToneCoefficients::make (driveK, toneOmega, color, note);
+    }
+
+    /** True if getDriveTone() could give a different answer for o. */
+    bool driveToneDiffers (const Sub808VoiceSettings& o) const noexcept
+    {
+        return ! juce::exactlyEqual (driveK, o.driveK) || ! juce::exactlyEqual (driveNorm, o.driveNorm)
+            || ! juce::exactlyEqual (toneFeedback, o.toneFeedback) || ! juce::exactlyEqual (toneInputGain, o.toneInputGain)
+            || ! juce::exactlyEqual (toneOmega, o.toneOmega) || ! juce::exactlyEqual (color, o.color);
+    }
+
+    static Sub808VoiceSettings fromValues (const Sub808Preset& v, double sampleRate) noexcept
+    {
+        Sub808VoiceSettings s;
+
+        s.gain    = v.gain;
+        s.attack  = v.attack;
+        s.decay   = v.decay;
+        s.sustain = v.sustain;
+        s.release = v.release;
+
+        s.pitchRatio = Sub808FastMath::semitonesToRatio (v.pitchSemitones);
+        s.glideTime  = v.glideTime;
+
+        s.toneOmega = 2.0f * juce::MathConstants<float>::pi * v.toneCutoff / (float) sampleRate;
+        s.color     = v.color;
+
+        const auto c = Sub808DriveToneCoefficients::make (v.drive > 0.0f ? juce::jmap (v.drive, 0.0f, 1.0f, 0.0f, 2.5f) : 0.0f,
+                                                          s.toneOmega, s.color);
+        s.driveK        = c.driveK;
+        s.driveNorm     = c.driveNorm; // same tanh as the kernel, so full scale maps to exactly 1
+        s.toneFeedback  = c.toneFeedback;
+        s.toneInputGain = c.toneInputGain;
+
+        return s;
+    }
+};
+
+class Sub808PresetMorph
+{
+public:
+    static constexpr int curveSize = 65;
+
+    void prepare (double newSampleRate)
+    {
+        sampleRateHz = newSampleRate;
+        position.reset (sampleRateHz, 0.02);
+        presetA = presetB = -1; // coefficients depend on the rate
+    }
+
+    /** Rebuilds the curves only if the pair actually changed. */
+    void setPresets (int indexA, int indexB) noexcept
+    {
+        indexA = juce::jlimit (0, Sub808Presets::numFactory - 1, indexA);
+        indexB = juce::jlimit (0, Sub808Presets::numFactory - 1, indexB);
+
+        if (indexA == presetA && indexB == presetB)
+            return;
+
+        presetA = indexA;
+        presetB = indexB;
+        rebuildCurves();
+    }
+
+    void setTarget (float amount) noexcept            { position.setTargetValue (juce::jlimit (0.0f, 1.0f, amount)); }
+    void jumpTo (float amount) noexcept               { position.setCurrentAndTargetValue (juce::jlimit (0.0f, 1.0f, amount)); }
+    bool isMoving() const noexcept                    { return position.isSmoothing(); }
+
+    Sub808VoiceSettings getCurrent() const noexcept   { return lookup (position.getCurrentValue()); }
+
+    /** Moves the smoothed position on by numSamples and returns the settings there. */
+    Sub808VoiceSettings advance (int numSamples) noexcept
+    {
+        return lookup (position.skip (numSamples));
+    }
+
+private:
+    void rebuildCurves() noexcept
+    {
+        const auto& a = Sub808Presets::factory[presetA];
+        const auto& b = Sub808Presets::factory[presetB];
+
+        const Sub808Preset delta { nullptr,
+                                   b.gain - a.gain, b.attack - a.attack, b.decay - a.decay,
+                                   b.sustain - a.sustain, b.release - a.release,
+                                   b.pitchSemitones - a.pitchSemitones, b.glideTime - a.glideTime,
+                                   b.drive - a.drive, b.color - a.color, b.toneCutoff - a.toneCutoff };
+
+        for (int i = 0; i < curveSize; ++i)
+        {
+            const float t = (float) i / (float) (curveSize - 1);
+
+            const Sub808Preset v { nullptr,
+                                   a.gain + t * delta.gain, a.attack + t * delta.attack, a.decay + t * delta.decay,
+                                   a.sustain + t * delta.sustain, a.release + t * delta.release,
+                                   a.pitchSemitones + t * delta.pitchSemitones, a.glideTime + t * delta.glideTime,
+                                   a.drive + t * delta.drive, a.color + t * delta.color, a.toneCutoff + t * delta.toneCutoff };
+
+            curve[i] = Sub808VoiceSettings::fromValues (v, sampleRateHz);
+        }
+    }
+
+    Sub808VoiceSettings lookup (float pos) const noexcept
+    {
+        const float x    = juce::jlimit (0.0f, 1.0f, pos) * (float) (curveSize - 1);
+        const int   i    = juce::jmin ((int) x, curveSize - 2);
+        const float frac = x - (float) i;
+
+        const auto& lo = curve[i];
+        const auto& hi = curve[i + 1];
+        auto lerp = [frac] (float from, float to) { return from + frac * (to - from); };
+
+        Sub808VoiceSettings s;
+        s.gain          = lerp (lo.gain,          hi.gain);
+        s.attack        = lerp (lo.attack,        hi.attack);
+        s.decay         = lerp (lo.decay,         hi.decay);
+        s.sustain       = lerp (lo.sustain,       hi.sustain);
+        s.release       = lerp (lo.release,       hi.release);
+        s.pitchRatio    = lerp (lo.pitchRatio,    hi.pitchRatio);
+        s.glideTime     = lerp (lo.glideTime,     hi.glideTime);
+        s.driveK        = lerp (lo.driveK,        hi.driveK);
+        s.toneFeedback  = lerp (lo.toneFeedback,  hi.toneFeedback);
+        s.toneInputGain = lerp (lo.toneInputGain, hi.toneInputGain);
+        s.toneOmega     = lerp (lo.toneOmega,     hi.toneOmega);
+        s.color         = lerp (lo.color,         hi.color);
+
+        // driveNorm = 1 / tanh (k) blows up as k -> 0, so interpolate tanh (k)
+        // (which is smooth through zero) and take the reciprocal instead.
+        const float tanhK = lerp (lo.driveK > 0.0f ? 1.0f / lo.driveNorm : 0.0f,
+                                  hi.driveK > 0.0f ? 1.0f / hi.driveNorm : 0.0f);
+        s.driveNorm = tanhK > 0.0f ? 1.0f / tanhK : 1.0f;
+        return s;
+    }
+
+    double sampleRateHz = 44100.0;
+    int presetA = -1, presetB = -1;
+
+    Sub808VoiceSettings curve[curveSize] {};
+    juce::SmoothedValue<float> position;
+};
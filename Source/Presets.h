@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    Presets.h
+    Factory presets, shared by the editor's preset menu and the processor's
+    A/B morph.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct Sub808Preset
+{
+    const char* name;
+    float gain;
+    float attack;
+    float decay;
+    float sustain;
+    float release;
+    float pitchSemitones; // -12..+12
+    float glideTime;      // seconds 0..0.3
+    float drive;          // 0..1
+    float color;          // -1..+1 (tilt)
+    float toneCutoff;     // Hz (normalized in processor)
+};
+
+namespace Sub808Presets
+{
+    // Preset { name, gain, attack, decay, sustain, release, pitchSemitones, glideTime, drive, color, toneCutoff }
+    inline constexpr Sub808Preset factory[] =
+    {
+        { "Default Clean 808", 0.70f, 0.02f, 0.20f, 0.60f, 0.30f,  0.0f, 0.00f, 0.10f,  0.00f, 300.0f },
+        { "Spinz 808",         0.85f, 0.00f, 0.12f, 0.55f, 0.20f,  0.0f, 0.02f, 0.45f,  0.35f, 450.0f },
+        { "Zay 808",           0.80f, 0.01f, 0.25f, 0.65f, 0.30f,  0.0f, 0.03f, 0.25f, -0.20f, 280.0f },
+        { "Subby Glide",       0.75f, 0.02f, 0.30f, 0.60f, 0.40f, -2.0f, 0.12f, 0.15f, -0.10f, 220.0f },
+        { "Punch 808",         0.90f, 0.00f, 0.10f, 0.50f, 0.18f,  0.0f, 0.01f, 0.50f,  0.40f, 520.0f },
+        { "Warm Tape 808",     0.78f, 0.02f, 0.22f, 0.62f, 0.28f, -1.0f, 0.02f, 0.30f, -0.35f, 260.0f },
+        { "Distorted 808",     0.95f, 0.00f, 0.12f, 0.50f, 0.22f,  0.0f, 0.00f, 0.75f,  0.45f, 600.0f },
+        { "Long Boom",         0.80f, 0.01f, 0.40f, 0.60f, 0.60f,  0.0f, 0.00f, 0.20f, -0.25f, 240.0f },
+        { "Soft Attack 808",   0.70f, 0.06f, 0.28f, 0.58f, 0.35f,  0.0f, 0.00f, 0.15f, -0.15f, 300.0f },
+        { "Tight Click 808",   0.88f, 0.00f, 0.08f, 0.45f, 0.15f,  0.0f, 0.00f, 0.40f,  0.50f, 650.0f },
+    };
+
+    inline constexpr int numFactory = (int) (sizeof (factory) / sizeof (factory[0]));
+
+    inline juce::StringArray getFactoryNames()
+    {
+        juce::StringArray names;
+
+        for (auto& p : factory)
+            names.add (p.name);
+
+        return names;
+    }
+}
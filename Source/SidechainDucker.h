@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    SidechainDucker.h
+    Kick-driven ducking of the synth's own output, from the optional
+    sidechain input bus.
+
+    Detection runs on short segments of the block rather than per sample:
+    each segment's peak or RMS comes from the levelDetect kernel, then one
+    envelope follower step and one gain computation happen per segment.
+    The output gain ramps linearly across each segment towards that
+    segment's value. Nothing is delayed, so the plugin reports no extra
+    latency. A kick's gain reduction is fully in place by the end of the
+    segment that contains it.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+#include "FastMath.h"
+
+class Sub808SidechainDucker
+{
+public:
+    static constexpr int segmentSize = 32;
+    static constexpr int maxSegments = 256; // larger blocks use longer segments
+
+    struct Parameters
+    {
+        float thresholdDb = -24.0f;
+        float depth       = 0.8f;   // gain reduction at full duck, 0..1
+        float attackMs    = 1.0f;
+        float releaseMs   = 120.0f;
+        bool  rms         = false;  // peak detection otherwise
+    };
+
+    void prepare (double newSampleRate) noexcept
+    {
+        sampleRateHz = newSampleRate;
+        fullSegment = {};
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        envelope = 0.0f;
+        lastGain = 1.0f;
+        numSegments = 0;
+    }
+
+    void setParameters (const Parameters& p) noexcept { params = p; }
+
+    /** Works out this block's gain curve. Must run before the block's
+        buffer is cleared: the sidechain channels share its storage. With no
+        sidechain channels the follower just releases back to unity. */
+    void analyse (const Sub808Dsp::KernelTable& kernels, const float* const* sidechain,
+                  int numChannels, int numSamples) noexcept
+    {
+        numSegments = 0;
+
+        if (numSamples <= 0)
+            return;
+
+        segmentLength = juce::jmax ((int) segmentSize, (numSamples + maxSegments - 1) / maxSegments);
+
+        // Full segments share one pair of coefficients, kept until the length
+        // or the times change; a short last segment gets its own.
+        if (segmentLength != fullSegment.length || ! juce::exactlyEqual (params.attackMs, fullSegment.attackMs)
+             || ! juce::exactlyEqual (params.releaseMs, fullSegment.releaseMs))
+            fullSegment = makeCoefficients (segmentLength);
+
+        const float threshold = juce::Decibels::decibelsToGain (params.thresholdDb);
+
+        for (int start = 0; start < numSamples; start += segmentLength)
+        {
+            const int n = juce::jmin (segmentLength, numSamples - start);
+            const auto coefs = n == segmentLength ? fullSegment : makeCoefficients (n);
+            float level = 0.0f;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float peak = 0.0f, sumSquares = 0.0f;
+                kernels.levelDetect (sidechain[ch] + start, n, peak, sumSquares);
+                level = juce::jmax (level, params.rms ? std::sqrt (sumSquares / (float) n) : peak);
+            }
+
+            envelope += (level > envelope ? coefs.attack : coefs.release) * (level - envelope);
+
+            if (! std::isfinite (envelope)) // garbage on the sidechain
+                envelope = 0.0f;
+
+            // Full depth once the sidechain is kneeDb over the threshold
+            const float overDb = envelope > threshold ? Sub808FastMath::gainToDecibels (envelope / threshold) : 0.0f;
+            gains[numSegments++] = 1.0f - params.depth * juce::jlimit (0.0f, 1.0f, overDb / kneeDb);
+        }
+
+        JUCE_SNAP_TO_ZERO (envelope);
+    }
+
+    /** Applies the gain curve from the last analyse() to every channel. */
+    void apply (juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+    {
+        for (int seg = 0, start = 0; seg < numSegments; ++seg, start += segmentLength)
+        {
+            const int n = juce::jmin (segmentLength, numSamples - start);
+            const float target = gains[seg];
+
+            if (! juce::exactlyEqual (lastGain, 1.0f) || ! juce::exactlyEqual (target, 1.0f))
+                buffer.applyGainRamp (start, n, lastGain, target);
+
+            lastGain = target;
+        }
+    }
+
+private:
+    static constexpr float kneeDb = 6.0f;
+
+    /** One-pole follower coefficients for a step of `length` samples, and
+        the settings they were made for. */
+    struct Coefficients
+    {
+        int   length = 0;
+        float attackMs = 0.0f, releaseMs = 0.0f;
+        float attack = 1.0f, release = 1.0f;
+    };
+
+    Coefficients makeCoefficients (int length) const noexcept
+    {
+        const float seconds = (float) length / (float) sampleRateHz;
+
+        Coefficients c;
+        c.length    = length;
+        c.attackMs  = params.attackMs;
+        c.releaseMs = params.releaseMs;
+        c.attack    = 1.0f - Sub808FastMath::exp (-seconds / juce::jmax (1.0e-5f, params.attackMs  * 0.001f));
+        c.release   = 1.0f - Sub808FastMath::exp (-seconds / juce::jmax (1.0e-5f, params.releaseMs * 0.001f));
+        return c;
+    }
+
+    double sampleRateHz = 44100.0;
+    Parameters params;
+
+    float envelope = 0.0f;
+    float lastGain = 1.0f;
+
+    int   segmentLength = segmentSize;
+    int   numSegments = 0;
+    Coefficients fullSegment;
+    float gains[maxSegments] {};
+};
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    UnisonStack.h
+    Detuned unison + sub-octave + octave-up oscillator stack.
+
+    Every layer lives in one lane of a fixed-width array, so the per-sample
+    loop in the oscillator kernel has a constant trip count and no branches
+    and gets vectorised into a handful of SIMD instructions. Unused lanes
+    simply carry a gain of zero, which keeps the cost flat regardless of the
+    voice count.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+#include "FastMath.h"
+
+class Sub808UnisonStack
+{
+public:
+    static constexpr int maxUnisonVoices = 8;
+    static constexpr int subLane         = maxUnisonVoices;     // one octave down
+    static constexpr int octaveLane      = maxUnisonVoices + 1; // one octave up
+    static constexpr int numLanes        = Sub808Dsp::OscillatorLanes::numLanes;
+
+    Sub808UnisonStack() { reset(); }
+
+    void prepare (double newSampleRate)
+    {
+        setSampleRate (newSampleRate);
+        reset();
+    }
+
+    /** Changes the render rate without touching the phases. */
+    void setSampleRate (double newSampleRate) noexcept
+    {
+        sampleRateHz = newSampleRate;
+    }
+
+    void reset() noexcept
+    {
+        // Spread the unison phases with the golden ratio so the detuned voices
+        // don't all start in phase (which sounds like a flam on the attack).
+        // Lane 0, the sub and the octave stay phase-aligned to keep the punch.
+        for (int i = 0; i < numLanes; ++i)
+        {
+            const float spread = (float) i * 0.6180339887f;
+            lanes.phase[i] = (i > 0 && i < maxUnisonVoices) ? spread - (float) (int) spread : 0.0f;
+        }
+    }
+
+    /** Recomputes the per-lane ratios and gains. Cheap to call every block:
+        the work is skipped unless one of the settings actually changed. */
+    void setParameters (int numVoices, float detuneCents, float spread,
+                        float blend, float subLevel, float octaveLevel) noexcept
+    {
+        numVoices = juce::jlimit (1, maxUnisonVoices, numVoices);
+
+        if (numVoices == lastVoices && juce::exactlyEqual (detuneCents, lastDetune)
+             && juce::exactlyEqual (spread, lastSpread) && juce::exactlyEqual (blend, lastBlend)
+             && juce::exactlyEqual (subLevel, lastSub) && juce::exactlyEqual (octaveLevel, lastOctave))
+            return;
+
+        lastVoices = numVoices;  lastDetune = detuneCents; lastSpread = spread;
+        lastBlend  = blend;      lastSub    = subLevel;    lastOctave = octaveLevel;
+
+        for (int i = 0; i < numLanes; ++i)
+        {
+            lanes.ratio[i] = 1.0f;
+            lanes.gainL[i] = 0.0f;
+            lanes.gainR[i] = 0.0f;
+        }
+
+        // Outer voices are faded by (1 - blend); the set is then normalised to
+        // constant power so changing the voice count doesn't jump in level.
+        float weights[maxUnisonVoices] {};
+        float pans[maxUnisonVoices] {};
+        float powerSum = 0.0f;
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            const float d = numVoices > 1 ? 2.0f * (float) v / (float) (numVoices - 1) - 1.0f : 0.0f;
+            lanes.ratio[v] = Sub808FastMath::semitonesToRatio (d * detuneCents * 0.01f);
+            pans[v]        = d * spread;
+            weights[v]     = 1.0f - std::abs (d) * (1.0f - blend);
+            powerSum      += weights[v] * weights[v];
+        }
+
+        const float norm = powerSum > 0.0f ? 1.0f / std::sqrt (powerSum) : 0.0f;
+
+        for (int v = 0; v < numVoices; ++v)
+            setLaneGain (v, weights[v] * norm, pans[v]);
+
+        lanes.ratio[subLane]    = 0.5f;
+        lanes.ratio[octaveLane] = 2.0f;
+        setLaneGain (subLane,    subLevel,    0.0f);
+        setLaneGain (octaveLane, octaveLevel, 0.0f);
+    }
+
+    /** Renders numSamples of the summed stack into left/right, following a
+        per-sample fundamental so glides stay sample-accurate. */
+    void renderBlock (const Sub808Dsp::KernelTable& kernels, const float* freqHz,
+                      float* left, float* right, int numSamples) noexcept
+    {
+        kernels.oscillator (lanes, freqHz, (float) (1.0 / sampleRateHz), left, right, numSamples);
+    }
+
+private:
+    void setLaneGain (int lane, float gain, float pan) noexcept
+    {
+        // Balance law: a centred lane keeps full level on both channels, so a
+        // single unpanned voice sounds exactly like the plain mono oscillator.
+        lanes.gainL[lane] = gain * juce::jmin (1.0f, 1.0f - pan);
+        lanes.gainR[lane] = gain * juce::jmin (1.0f, 1.0f + pan);
+    }
+
+    double sampleRateHz = 44100.0;
+
+    Sub808Dsp::OscillatorLanes lanes;
+
+    int   lastVoices = -1;
+    float lastDetune = -1.0f, lastSpread = -1.0f, lastBlend = -1.0f;
+    float lastSub    = -1.0f, lastOctave = -1.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Sub808UnisonStack)
+};
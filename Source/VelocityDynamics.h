@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+    VelocityDynamics.h
+    Velocity and accent response: how hard a note is played sets its level,
+    drive and tone, and accented notes get the 808 accent boost.
+
+    The response curves (pow, cos) are only evaluated when a setting
+    changes, into one 128-entry table per destination. A note-on is then a
+    table lookup and a couple of multiplies however dense the MIDI is, and
+    turning the result into filter and drive coefficients costs one
+    FastMath exp and tanh.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+
+/** How one note responds to the way it was played. */
+struct Sub808NoteDynamics
+{
+    float level      = 1.0f; // envelope peak, 0..1
+    float driveScale = 1.0f; // multiplies the drive pre-gain
+    float toneRatio  = 1.0f; // multiplies the tone cutoff
+};
+
+/** Drive and tone-filter coefficients with a note's dynamics applied. */
+struct Sub808DriveToneCoefficients
+{
+    float driveK;        // tanh pre-gain, 0 = drive off
+    float driveNorm;     // 1 / tanh (driveK)
+    float toneFeedback;  // color tilt folded into the one-pole tone filter
+    float toneInputGain;
+
+    /** toneOmega is 2 * pi * cutoff / sampleRate, color is -1..1. */
+    static Sub808DriveToneCoefficients make (float driveK, float toneOmega, float color,
+                                             const Sub808NoteDynamics& note = {}) noexcept
+    {
+        Sub808DriveToneCoefficients c;
+
+        c.driveK    = driveK * note.driveScale;
+        c.driveNorm = c.driveK > 0.0f ? 1.0f / Sub808FastMath::tanh (c.driveK) : 1.0f;
+
+        // Simple tilt EQ (color): brighten (positive) or warm (negative), applied as
+        // pre-emphasis against the previous tone-filter output. With
+        //   s' = s + (s - z) * color/2 + s * color/2
+        //   z  = toneAlpha * z + (1 - toneAlpha) * s'
+        // both collapse into a single one-pole: z = feedback * z + inputGain * s.
+        const float toneAlpha = juce::jlimit (0.0f, 1.0f, Sub808FastMath::exp (-toneOmega * note.toneRatio));
+        c.toneFeedback  = toneAlpha - 0.5f * color * (1.0f - toneAlpha);
+        c.toneInputGain = (1.0f - toneAlpha) * (1.0f + color);
+
+        return c;
+    }
+};
+
+//==============================================================================
+class Sub808VelocityDynamics
+{
+public:
+    enum class Curve { linear, soft, hard, sCurve };
+    enum class AccentSource { off, velocity, controller };
+
+    static juce::StringArray getCurveNames()        { return { "Linear", "Soft", "Hard", "S-Curve" }; }
+    static juce::StringArray getAccentSourceNames() { return { "Off", "Velocity", "CC" }; }
+
+    struct Parameters
+    {
+        Curve curve       = Curve::linear;
+        float levelAmount = 0.0f;  // 0 = every note at full level
+        float driveAmount = 0.0f;  // 0 = drive ignores velocity
+        float toneAmount  = 0.0f;  // 0 = tone ignores velocity
+
+        AccentSource accentSource = AccentSource::off;
+        int   accentThreshold     = 100; // lowest accented velocity
+        int   accentController    = 16;  // held at 64 or above = accent
+        float accentAmount        = 0.3f;
+        float patternAccentAmount = 0.3f;
+
+        bool operator== (const Parameters& o) const noexcept
+        {
+            return curve == o.curve && juce::exactlyEqual (levelAmount, o.levelAmount)
+                && juce::exactlyEqual (driveAmount, o.driveAmount) && juce::exactlyEqual (toneAmount, o.toneAmount)
+                && accentSource == o.accentSource && accentThreshold == o.accentThreshold
+                && accentController == o.accentController && juce::exactlyEqual (accentAmount, o.accentAmount)
+                && juce::exactlyEqual (patternAccentAmount, o.patternAccentAmount);
+        }
+
+        bool operator!= (const Parameters& o) const noexcept { return ! operator== (o); }
+    };
+
+    Sub808VelocityDynamics() { rebuildTables(); }
+
+    /** Cheap when nothing changed; otherwise rebuilds the tables. */
+    void setParameters (const Parameters& newParams) noexcept
+    {
+        if (newParams == params)
+            return;
+
+        params = newParams;
+        rebuildTables();
+    }
+
+    void reset() noexcept { accentHeld = false; }
+
+    void handleController (int number, int value) noexcept
+    {
+        if (number == params.accentController)
+            accentHeld = value >= 64;
+    }
+
+    /** A MIDI note-on. */
+    Sub808NoteDynamics getNote (int velocity) const noexcept
+    {
+        const int v = juce::jlimit (0, 127, velocity);
+        const Sub808NoteDynamics note { levelTable[v], driveTable[v], toneTable[v] };
+
+        switch (params.accentSource)
+        {
+            case AccentSource::velocity:   return applyAccent (note, v >= params.accentThreshold, midiAccent);
+            case AccentSource::controller: return applyAccent (note, accentHeld, midiAccent);
+            case AccentSource::off:        break;
+        }
+
+        return note;
+    }
+
+    /** A pattern step: full velocity, accented or not. */
+    Sub808NoteDynamics getPatternNote (bool accented) const noexcept
+    {
+        return applyAccent ({}, accented, patternAccent);
+    }
+
+private:
+    static constexpr int   tableSize         = 128;
+    static constexpr float toneRangeOctaves  = 3.0f; // how much darker the softest note gets
+    static constexpr float accentToneOctaves = 1.0f; // how much brighter an accent gets at full amount
+
+    /** Unaccented notes sit the accent amount below full level; accented
+        ones keep their level and get more drive and a brighter tone. */
+    struct Accent
+    {
+        float unaccentedLevel = 1.0f, driveScale = 1.0f, toneRatio = 1.0f;
+    };
+
+    static Accent makeAccent (float amount) noexcept
+    {
+        return { 1.0f - amount, 1.0f + amount, std::exp2 (amount * accentToneOctaves) };
+    }
+
+    static Sub808NoteDynamics applyAccent (Sub808NoteDynamics note, bool accented, const Accent& a) noexcept
+    {
+        if (accented)
+        {
+            note.driveScale *= a.driveScale;
+            note.toneRatio  *= a.toneRatio;
+        }
+        else
+        {
+            note.level *= a.unaccentedLevel;
+        }
+
+        return note;
+    }
+
+    /** Velocity 0..1 to response 0..1. */
+    static float shape (Curve curve, float x) noexcept
+    {
+        switch (curve)
+        {
+            case Curve::soft:   return std::sqrt (x);     // most of the range in the soft notes
+            case Curve::hard:   return std::pow (x, 2.5f); // only hard hits get near full
+            case Curve::sCurve: return 0.5f - 0.5f * std::cos (juce::MathConstants<float>::pi * x);
+            case Curve::linear: break;
+        }
+
+        return x;
+    }
+
+    void rebuildTables() noexcept
+    {
+        for (int v = 0; v < tableSize; ++v)
+        {
+            const float missing = 1.0f - shape (params.curve, (float) v / 127.0f);
+
+            levelTable[v] = 1.0f - params.levelAmount * missing;
+            driveTable[v] = 1.0f - params.driveAmount * missing;
+            toneTable[v]  = std::exp2 (-params.toneAmount * toneRangeOctaves * missing);
+        }
+
+        midiAccent    = makeAccent (params.accentAmount);
+        patternAccent = makeAccent (params.patternAccentAmount);
+    }
+
+    Parameters params;
+    bool accentHeld = false;
+
+    float levelTable[tableSize] {};
+    float driveTable[tableSize] {};
+    float toneTable[tableSize] {};
+    Accent midiAccent, patternAccent;
+};
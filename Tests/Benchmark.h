@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    Benchmark.h
+    Timing helper shared by the benchmarks and the fuzz test's block budget.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Sub808Bench
+{
+    /** Seconds one call to fn takes: the best of several rounds, so a context
+        switch in one round doesn't skew the figure. */
+    template <typename Fn>
+    double secondsPerCall (Fn&& fn, int callsPerRound, int rounds = 5)
+    {
+        double best = std::numeric_limits<double>::max();
+
+        for (int r = 0; r < rounds; ++r)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int i = 0; i < callsPerRound; ++i)
+                fn();
+
+            const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+            best = juce::jmin (best, juce::Time::highResolutionTicksToSeconds (elapsed) / callsPerRound);
+        }
+
+        return best;
+    }
+
+    inline juce::String nanoseconds (double seconds)
+    {
+        return juce::String (seconds * 1.0e9, 2) + " ns";
+    }
+}
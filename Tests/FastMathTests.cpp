@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    FastMathTests.cpp
+    Checks every error bound documented in FastMath.h against long double
+    libm, and that the domains those bounds are quoted over cover what the
+    parameter ranges in createParameterLayout() can feed each function.
+
+    Inputs are drawn at random (exponent and mantissa separately for the
+    logarithms), not on a grid: stepping through exp2 of a grid lands on
+    mantissas the log2 polynomial happens to get right and hides its error.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+#include "SidechainDucker.h"
+#include "TestProcessor.h"
+#include "VelocityDynamics.h"
+
+class Sub808FastMathTests : public juce::UnitTest
+{
+public:
+    Sub808FastMathTests() : juce::UnitTest ("FastMath", "Sub808") {}
+
+    void runTest() override
+    {
+        namespace F = Sub808FastMath;
+        auto random = getRandom();
+
+        beginTest ("sin2Pi");
+        checkAbs ("sin2Pi over [0, 1)", 1.9e-7, uniform (random, 0.0f, 1.0f),
+                  [] (float p) { return F::sin2Pi (p); },
+                  [] (long double p) { return std::sin (2.0L * juce::MathConstants<long double>::pi * p); });
+
+        beginTest ("tanh");
+        const std::initializer_list<float> tanhWorst { 5.82787609f, -5.82787609f }; // found by an exhaustive sweep
+        checkAbs ("tanh over +-20", 4.2e-7, including (uniform (random, -20.0f, 20.0f), tanhWorst),
+                  [] (float x) { return F::tanh (x); },
+                  [] (long double x) { return std::tanh (x); });
+        checkRel ("tanh over +-8", 4.2e-7, including (uniform (random, -8.0f, 8.0f), tanhWorst),
+                  [] (float x) { return F::tanh (x); },
+                  [] (long double x) { return std::tanh (x); });
+        expectEquals (F::tanh (1.0e30f), 1.0f, "saturates");
+
+        beginTest ("exp2");
+        checkRel ("exp2 over +-126", 2.4e-7, uniform (random, -126.0f, 126.0f),
+                  [] (float x) { return F::exp2 (x); },
+                  [] (long double x) { return std::exp2 (x); });
+
+        beginTest ("exp");
+        checkRel ("exp over [-3, 0]", 3.6e-7, uniform (random, -3.0f, 0.0f),
+                  [] (float x) { return F::exp (x); },
+                  [] (long double x) { return std::exp (x); });
+        checkRel ("exp over +-10", 6.9e-7, uniform (random, -10.0f, 10.0f),
+                  [] (float x) { return F::exp (x); },
+                  [] (long double x) { return std::exp (x); });
+
+        beginTest ("semitonesToRatio");
+        checkRel ("semitonesToRatio over +-36", 3.5e-7, uniform (random, -36.0f, 36.0f),
+                  [] (float x) { return F::semitonesToRatio (x); },
+                  [] (long double x) { return std::exp2 (x / 12.0L); });
+
+        beginTest ("log2");
+        auto log2 = [] (float x) { return F::log2 (x); };
+        auto log2Ref = [] (long double x) { return std::log2 (x); };
+        checkAbs ("log2 over [0.5, 2)",        1.3e-7, octaves (random, -1, 1),     log2, log2Ref);
+        checkAbs ("log2 over 2^+-8",           3.4e-7, octaves (random, -8, 8),     log2, log2Ref);
+        checkAbs ("log2 over 2^+-20",          1.1e-6, octaves (random, -20, 20),   log2, log2Ref);
+        checkAbs ("log2 over [2^-120, 2^120]", 3.9e-6, octaves (random, -120, 120), log2, log2Ref);
+        expectEquals (F::log2 (1.0f), 0.0f, "log2 (1)");
+        expect (std::isfinite (F::log2 (0.0f)), "log2 (0) is finite");
+
+        beginTest ("gainToDecibels");
+        auto dB = [] (float x) { return F::gainToDecibels (x); };
+        auto dBRef = [] (long double x) { return 20.0L * std::log10 (x); };
+        checkAbs ("gainToDecibels over +-12 dB",  1.5e-6, octaves (random, -2, 2),   dB, dBRef);
+        checkAbs ("gainToDecibels over +-48 dB",  4.4e-6, octaves (random, -8, 8),   dB, dBRef);
+        checkAbs ("gainToDecibels over +-120 dB", 1.2e-5, octaves (random, -20, 20), dB, dBRef);
+
+        beginTest ("Bounds cover the parameter ranges");
+        checkParameterDomains();
+    }
+
+private:
+    static constexpr int numSamples = 1 << 20;
+
+    /** Where each FastMath call gets its input from, checked against the
+        domain its bound is documented over. */
+    void checkParameterDomains()
+    {
+        Sub808TestProcessor p;
+        auto& apvts = p.processor.apvts;
+
+        // semitonesToRatio: pitch, kit tune and unison detune (cents) within +-36
+        const auto pitch  = apvts.getParameterRange ("pitchSemitones");
+        const auto tune   = apvts.getParameterRange ("slot1_tune");
+        const auto detune = apvts.getParameterRange ("unisonDetune");
+        expect (pitch.start >= -36.0f && pitch.end <= 36.0f, "pitch");
+        expect (tune.start >= -36.0f && tune.end <= 36.0f, "kit tune");
+        expect (detune.end * 0.01f <= 36.0f, "unison detune");
+
+        // exp on the tone filter: -2 pi cutoff / sampleRate times the
+        // brightest a fully accented note gets, within [-3, 0] at 44.1 kHz
+        Sub808VelocityDynamics dynamics;
+        Sub808VelocityDynamics::Parameters loudest;
+        loudest.accentSource = Sub808VelocityDynamics::AccentSource::velocity;
+        loudest.accentAmount = 1.0f;
+        dynamics.setParameters (loudest);
+
+        const float maxToneRatio = dynamics.getNote (127).toneRatio;
+        const float maxOmega = juce::MathConstants<float>::twoPi * apvts.getParameterRange ("toneCutoff").end / 44100.0f;
+        expectLessOrEqual (maxOmega * maxToneRatio, 3.0f, "tone filter exponent");
+
+        // exp in the ducker: one segment over the shortest attack, within 10
+        const float segmentSeconds = (float) Sub808SidechainDucker::segmentSize / 44100.0f;
+        const float shortestAttack = apvts.getParameterRange ("duckAttack").start * 0.001f;
+        expectLessOrEqual (segmentSeconds / shortestAttack, 10.0f, "ducker exponent");
+
+        // gainToDecibels in the ducker: the sidechain over the threshold. The
+        // lowest threshold leaves room for a sidechain 60 dB over full scale.
+        expectGreaterOrEqual (apvts.getParameterRange ("duckThreshold").start, -60.0f, "ducker threshold");
+    }
+
+    static std::vector<float> uniform (juce::Random& random, float low, float high)
+    {
+        std::vector<float> x ((size_t) numSamples);
+
+        for (auto& v : x)
+            v = juce::jlimit (low, std::nextafter (high, low), low + (high - low) * random.nextFloat());
+
+        return x;
+    }
+
+    /** x plus inputs that must always be checked. */
+    static std::vector<float> including (std::vector<float> x, std::initializer_list<float> fixed)
+    {
+        x.insert (x.end(), fixed.begin(), fixed.end());
+        return x;
+    }
+
+    /** Random mantissas in random octaves [2^low, 2^high). */
+    static std::vector<float> octaves (juce::Random& random, int low, int high)
+    {
+        std::vector<float> x ((size_t) numSamples);
+
+        for (auto& v : x)
+            v = std::ldexp (1.0f + random.nextFloat(), low + random.nextInt (high - low));
+
+        return x;
+    }
+
+    template <typename Fn, typename Ref>
+    void checkAbs (const juce::String& name, double bound, const std::vector<float>& inputs, Fn fn, Ref ref)
+    {
+        double worst = 0.0;
+
+        for (auto x : inputs)
+            worst = juce::jmax (worst, (double) std::abs ((long double) fn (x) - ref ((long double) x)));
+
+        report (name, worst, bound, "abs");
+    }
+
+    template <typename Fn, typename Ref>
+    void checkRel (const juce::String& name, double bound, const std::vector<float>& inputs, Fn fn, Ref ref)
+    {
+        double worst = 0.0;
+
+        for (auto x : inputs)
+        {
+            const long double exact = ref ((long double) x);
+
+            if (! juce::exactlyEqual (exact, 0.0L))
+                worst = juce::jmax (worst, (double) std::abs (((long double) fn (x) - exact) / exact));
+        }
+
+        report (name, worst, bound, "rel");
+    }
+
+    void report (const juce::String& name, double worst, double bound, const char* kind)
+    {
+        logMessage (name + ": max " + kind + " error " + juce::String (worst * 1.0e6, 4) + "e-6 (documented "
+                      + juce::String (bound * 1.0e6, 4) + "e-6)");
+        expectLessOrEqual (worst, bound, name);
+    }
+};
+
+static Sub808FastMathTests fastMathTests;
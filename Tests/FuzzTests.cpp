@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+    FuzzTests.cpp
+    Throws random hosts at the processor: block sizes from 0 up, random MIDI
+    (including all-notes-off and every controller), full-range parameter
+    jumps, garbage on the sidechain and an erratic transport. Every block
+    must come back finite, bounded, free of denormals and within its time
+    budget. Rerun a failure with the seed the runner printed (--seed N).
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "TestProcessor.h"
+#include <ctime>
+
+class Sub808FuzzTests : public juce::UnitTest
+{
+public:
+    Sub808FuzzTests() : juce::UnitTest ("Fuzz", "Sub808") {}
+
+    void runTest() override
+    {
+        for (double sampleRate : { 44100.0, 96000.0, 192000.0 })
+        {
+            for (bool allBuses : { false, true })
+            {
+                beginTest (juce::String (sampleRate / 1000.0, 1) + " kHz, "
+                             + (allBuses ? "sidechain and kit buses on" : "main output only"));
+                fuzz (sampleRate, allBuses);
+            }
+        }
+    }
+
+private:
+    static constexpr int   maxBlockSize = 2048;
+    static constexpr int   numBlocks    = 3000;
+    static constexpr float maxOutput    = 16.0f;   // +24 dBFS; anything louder is a bug
+    static constexpr double slackSeconds = 0.001;  // per block, for clock granularity
+
+    /** A transport that plays, stops, loops and jumps at random. */
+    struct FuzzPlayHead : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            if (! valid)
+                return {};
+
+            return info;
+        }
+
+        PositionInfo info;
+        bool valid = true;
+    };
+
+    void fuzz (double sampleRate, bool allBuses)
+    {
+        auto random = getRandom();
+
+        Sub808TestProcessor p;
+        FuzzPlayHead playHead;
+
+        if (allBuses)
+            p.processor.enableAllBuses();
+
+        p.processor.setPlayHead (&playHead);
+        p.prepare (sampleRate, maxBlockSize);
+
+        double ppq = 0.0;
+        int numNonFinite = 0, numDenormal = 0, numTooLoud = 0, numOverBudget = 0;
+        float peak = 0.0f;
+        double worstLoad = 0.0;
+
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            const int numSamples = randomBlockSize (random);
+
+            if (random.nextInt (8) == 0)
+                jumpParameters (p, random);
+
+            addRandomMidi (p.midi, random, numSamples);
+            moveTransport (playHead, random, ppq, numSamples, sampleRate);
+
+            // What's left in the buffer is what the host passes in: sidechain
+            // noise, with the odd NaN / Inf, on every channel.
+            juce::AudioBuffer<float> hostBuffer (p.buffer.getArrayOfWritePointers(), p.buffer.getNumChannels(), numSamples);
+
+            for (int ch = 0; ch < hostBuffer.getNumChannels(); ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    hostBuffer.setSample (ch, i, randomInputSample (random));
+
+            // CPU time, not wall time: a test runner that gets preempted
+            // mid-block hasn't found a slow block.
+            const auto start = std::clock();
+            p.processor.processBlock (hostBuffer, p.midi);
+            const double seconds = (double) (std::clock() - start) / CLOCKS_PER_SEC;
+            p.midi.clear();
+
+            const double blockSeconds = numSamples / sampleRate;
+
+            if (seconds > blockSeconds + slackSeconds)
+                ++numOverBudget;
+
+            if (numSamples >= 64)
+                worstLoad = juce::jmax (worstLoad, seconds / blockSeconds);
+
+            for (int ch = 0; ch < hostBuffer.getNumChannels(); ++ch)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float x = hostBuffer.getSample (ch, i);
+
+                    if (! std::isfinite (x))
+                        ++numNonFinite;
+                    else if (std::fpclassify (x) == FP_SUBNORMAL)
+                        ++numDenormal;
+                    else if (std::abs (x) > maxOutput)
+                        ++numTooLoud;
+
+                    if (std::isfinite (x))
+                        peak = juce::jmax (peak, std::abs (x));
+                }
+            }
+        }
+
+        p.processor.setPlayHead (nullptr);
+
+        logMessage ("peak " + juce::String (peak, 3) + ", worst real-time load " + juce::String (worstLoad * 100.0, 1) + "%");
+
+        expectEquals (numNonFinite,  0, "non-finite output samples");
+        expectEquals (numDenormal,   0, "denormal output samples");
+        expectEquals (numTooLoud,    0, "output samples above the bound");
+        expectEquals (numOverBudget, 0, "blocks slower than real time");
+    }
+
+    static int randomBlockSize (juce::Random& random)
+    {
+        switch (random.nextInt (8))
+        {
+            case 0:  return 0;
+            case 1:  return 1;
+            case 2:  return 1 + random.nextInt (16);
+            default: return random.nextInt (maxBlockSize + 1);
+        }
+    }
+
+    static float randomInputSample (juce::Random& random)
+    {
+        const int r = random.nextInt (10000);
+
+        if (r == 0) return std::numeric_limits<float>::quiet_NaN();
+        if (r == 1) return std::numeric_limits<float>::infinity();
+
+        return random.nextFloat() * 4.0f - 2.0f;
+    }
+
+    /** Every parameter to a random point in its range, often an end stop. */
+    static void jumpParameters (Sub808TestProcessor& p, juce::Random& random)
+    {
+        for (auto* param : p.processor.getParameters())
+        {
+            const int r = random.nextInt (4);
+            param->setValueNotifyingHost (r == 0 ? 0.0f : (r == 1 ? 1.0f : random.nextFloat()));
+        }
+    }
+
+    static void addRandomMidi (juce::MidiBuffer& midi, juce::Random& random, int numSamples)
+    {
+        if (random.nextInt (3) != 0)
+            return;
+
+        const int numEvents = random.nextInt (65);
+
+        for (int e = 0; e < numEvents; ++e)
+        {
+            // Hosts occasionally put events just outside the block
+            const int position = numSamples > 0 ? random.nextInt (numSamples + 4) - 2 : 0;
+            const int note     = random.nextInt (128);
+            const auto velocity = (juce::uint8) (1 + random.nextInt (127));
+
+            juce::MidiMessage msg;
+
+            switch (random.nextInt (10))
+            {
+                case 0: case 1: case 2: case 3: msg = juce::MidiMessage::noteOn  (1, note, velocity); break;
+                case 4: case 5: case 6:         msg = juce::MidiMessage::noteOff (1, note, velocity); break;
+                case 7:                         msg = juce::MidiMessage::allNotesOff (1); break;
+                case 8:                         msg = juce::MidiMessage::allSoundOff (1); break;
+                default:                        msg = juce::MidiMessage::controllerEvent (1, random.nextInt (128), random.nextInt (128)); break;
+            }
+
+            midi.addEvent (msg, position);
+        }
+    }
+
+    static void moveTransport (FuzzPlayHead& playHead, juce::Random& random, double& ppq, int numSamples, double sampleRate)
+    {
+        auto& info = playHead.info;
+        const double bpm = random.nextInt (50) == 0 ? random.nextDouble() * 1000.0 - 10.0
+                                                    : 60.0 + random.nextDouble() * 140.0;
+
+        if (random.nextInt (30) == 0)
+            ppq = random.nextDouble() * 104.0 - 4.0;
+
+        playHead.valid = random.nextInt (40) != 0;
+        info.setBpm (bpm);
+        info.setPpqPosition (ppq);
+        info.setIsPlaying (random.nextInt (20) != 0);
+        info.setIsLooping (random.nextInt (3) == 0);
+        info.setLoopPoints (juce::AudioPlayHead::LoopPoints { random.nextDouble() * 8.0, random.nextDouble() * 16.0 });
+
+        ppq += numSamples / sampleRate * juce::jmax (1.0, bpm) / 60.0;
+    }
+};
+
+static Sub808FuzzTests fuzzTests;
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    KernelBenchmarks.cpp
+    Times every kernel in each kernel set the CPU can run, and checks that
+    the wider sets still compute the same thing as the generic one.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Benchmark.h"
+#include "DspKernels.h"
+
+class Sub808KernelBenchmarks : public juce::UnitTest
+{
+public:
+    Sub808KernelBenchmarks() : juce::UnitTest ("Kernel benchmarks", "Sub808 Benchmarks") {}
+
+    void runTest() override
+    {
+        using namespace Sub808Dsp;
+
+        juce::ScopedNoDenormals noDenormals; // as in processBlock
+
+        Results reference;
+
+        for (auto isa : { Isa::generic, Isa::sse2, Isa::avx2, Isa::avx512 })
+        {
+            setIsaOverride (isa);
+            const auto& kernels = getKernels();
+
+            if (kernels.isa != isa)
+                continue; // not compiled in, or more than this CPU can run
+
+            beginTest (getIsaName (isa));
+
+            const auto results = run (kernels);
+
+            if (isa == Isa::generic)
+            {
+                reference = results;
+                continue;
+            }
+
+            // FMA contraction and lane order move the last bits, nothing more
+            for (int i = 0; i < blockSize; ++i)
+            {
+                expectWithinAbsoluteError (results.oscillator[i], reference.oscillator[i], 1.0e-4f, "oscillator");
+                expectWithinAbsoluteError (results.drive[i], reference.drive[i], 1.0e-5f, "drive");
+            }
+
+            for (int i = 0; i < kitBlockSize * KitLanes::numLanes; ++i)
+                expectWithinAbsoluteError (results.kit[i], reference.kit[i], 1.0e-5f, "kit");
+        }
+
+        clearIsaOverride();
+    }
+
+private:
+    static constexpr int    blockSize    = 512;
+    static constexpr int    kitBlockSize = 128;
+    static constexpr int    calls        = 2000;
+    static constexpr double sampleRate   = 48000.0;
+
+    struct Results
+    {
+        std::vector<float> oscillator, drive, kit;
+    };
+
+    Results run (const Sub808Dsp::KernelTable& kernels)
+    {
+        using namespace Sub808Dsp;
+
+        Results results;
+        std::vector<float> freq ((size_t) blockSize, 55.0f), left ((size_t) blockSize), right ((size_t) blockSize);
+        std::vector<float> data ((size_t) blockSize);
+
+        // Oscillator: a full unison stack
+        OscillatorLanes osc;
+
+        for (int v = 0; v < OscillatorLanes::numLanes; ++v)
+        {
+            osc.ratio[v] = 1.0f + 0.001f * (float) v;
+            osc.gainL[v] = osc.gainR[v] = 1.0f / OscillatorLanes::numLanes;
+        }
+
+        report ("oscillator", Sub808Bench::secondsPerCall ([&]
+        {
+            kernels.oscillator (osc, freq.data(), (float) (1.0 / sampleRate), left.data(), right.data(), blockSize);
+        }, calls), blockSize);
+
+        OscillatorLanes fresh = osc;
+        std::fill (std::begin (fresh.phase), std::end (fresh.phase), 0.0f);
+        kernels.oscillator (fresh, freq.data(), (float) (1.0 / sampleRate), left.data(), right.data(), blockSize);
+        results.oscillator = left;
+
+        // Drive over a full-scale sine
+        auto fillSine = [&]
+        {
+            for (int i = 0; i < blockSize; ++i)
+                data[(size_t) i] = std::sin (juce::MathConstants<float>::twoPi * (float) i / 64.0f);
+        };
+
+        fillSine();
+        report ("drive", Sub808Bench::secondsPerCall ([&] { kernels.drive (data.data(), blockSize, 2.5f, 1.0f); }, calls), blockSize);
+
+        fillSine();
+        kernels.drive (data.data(), blockSize, 2.5f, 1.0f / std::tanh (2.5f));
+        results.drive = data;
+
+        fillSine();
+        float peak = 0.0f, sumSquares = 0.0f;
+        report ("levelDetect", Sub808Bench::secondsPerCall ([&] { kernels.levelDetect (data.data(), blockSize, peak, sumSquares); }, calls), blockSize);
+
+        float z = 0.0f;
+        report ("toneFilter", Sub808Bench::secondsPerCall ([&] { kernels.toneFilter (data.data(), blockSize, z, 0.9f, 0.1f); }, calls), blockSize);
+
+        // Envelope segment: a long decay
+        float coefPowers[envelopeSegmentLanes];
+        const float coef = 0.9999f;
+        coefPowers[0] = coef;
+
+        for (int k = 1; k < envelopeSegmentLanes; ++k)
+            coefPowers[k] = coefPowers[k - 1] * coef;
+
+        float offset = 1.0f;
+        report ("envelopeSegment", Sub808Bench::secondsPerCall ([&]
+        {
+            offset = 1.0f;
+            kernels.envelopeSegment (data.data(), blockSize, 0.0f, offset, coefPowers, coefPowers[envelopeSegmentLanes - 1], coef);
+        }, calls), blockSize);
+
+        // Kit: every slot sounding, every other one driven
+        auto makeKit = []
+        {
+            KitLanes kit;
+
+            for (int v = 0; v < KitLanes::numLanes; ++v)
+            {
+                const bool driven = v % 2 == 0;
+                kit.phaseInc[v]      = (float) ((40.0 + 10.0 * v) / sampleRate);
+                kit.envOffset[v]     = 1.0f;
+                kit.envCoef[v]       = 0.9999f;
+                kit.driveK[v]        = driven ? 2.0f : KitLanes::transparentDriveK;
+                kit.driveNorm[v]     = 1.0f / std::tanh (kit.driveK[v]);
+                kit.toneFeedback[v]  = 0.9f;
+                kit.toneInputGain[v] = 0.1f;
+            }
+
+            return kit;
+        };
+
+        auto kit = makeKit();
+        std::vector<float> kitOut ((size_t) (kitBlockSize * KitLanes::numLanes));
+        report ("kit (16 slots)", Sub808Bench::secondsPerCall ([&] { kernels.kit (kit, kitOut.data(), kitBlockSize); }, calls), kitBlockSize);
+
+        kit = makeKit();
+        kernels.kit (kit, kitOut.data(), kitBlockSize);
+        results.kit = kitOut;
+
+        return results;
+    }
+
+    void report (const char* kernel, double secondsPerBlock, int samplesPerBlock)
+    {
+        logMessage (juce::String (kernel) + ": " + Sub808Bench::nanoseconds (secondsPerBlock / samplesPerBlock) + " per sample");
+    }
+};
+
+static Sub808KernelBenchmarks kernelBenchmarks;
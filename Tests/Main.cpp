@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Runs the Sub808 unit tests, or with --bench the benchmarks. Exits
+    non-zero if anything failed. --seed N repeats a run with the same
+    random seed (the seed is printed at the start of each test).
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+int main (int argc, char* argv[])
+{
+    // The processor owns a Timer, which needs the message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+
+    for (int i = 1; i < argc; ++i)
+        args.add (argv[i]);
+
+    const bool benchmarks = args.contains ("--bench");
+    const int seedIndex = args.indexOf ("--seed");
+    const juce::int64 seed = seedIndex >= 0 ? args[seedIndex + 1].getLargeIntValue() : 0;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure (false);
+    runner.runTestsInCategory (benchmarks ? "Sub808 Benchmarks" : "Sub808", seed);
+
+    int failures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult (i)->failures;
+
+    return failures > 0 ? 1 : 0;
+}
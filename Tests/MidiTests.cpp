@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    MidiTests.cpp
+    MIDI handling that the fuzz test can't judge by ear: all-notes-off and
+    all-sound-off must silence both engines.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "TestProcessor.h"
+
+class Sub808MidiTests : public juce::UnitTest
+{
+public:
+    Sub808MidiTests() : juce::UnitTest ("MIDI", "Sub808") {}
+
+    void runTest() override
+    {
+        for (bool kitMode : { false, true })
+        {
+            const juce::String engine (kitMode ? "kit" : "sub");
+
+            beginTest ("All notes off silences the " + engine + " engine");
+            expectLessThan (peakAfter (juce::MidiMessage::allNotesOff (1), kitMode), silence);
+
+            beginTest ("All sound off silences the " + engine + " engine");
+            expectLessThan (peakAfter (juce::MidiMessage::allSoundOff (1), kitMode), silence);
+
+            beginTest ("Other controllers leave the " + engine + " note sounding");
+            expectGreaterThan (peakAfter (juce::MidiMessage::controllerEvent (1, 1, 64), kitMode), silence);
+        }
+    }
+
+private:
+    static constexpr int   blockSize = 1024;
+    static constexpr float silence   = 1.0e-3f;
+
+    /** Plays a long note (slot 1's note in kit mode), sends msg, and returns
+        the output peak once the tone filter has had a block to settle. */
+    static float peakAfter (const juce::MidiMessage& msg, bool kitMode)
+    {
+        Sub808TestProcessor p;
+        p.setParameter ("kitMode", kitMode ? 1.0f : 0.0f);
+        p.setParameter ("sustain", 1.0f);
+        p.setParameter ("release", 5.0f);
+        p.setParameter ("slot1_decay", 4.0f);
+        p.prepare (48000.0, blockSize);
+
+        p.midi.addEvent (juce::MidiMessage::noteOn (1, 36, (juce::uint8) 127), 0);
+        p.process (blockSize);
+
+        p.midi.addEvent (msg, 0);
+        p.process (blockSize);
+        p.process (blockSize);
+
+        return p.buffer.getMagnitude (0, blockSize);
+    }
+};
+
+static Sub808MidiTests midiTests;
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    MultirateTests.cpp
+    The multirate core's reported latency, and what it saves.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Benchmark.h"
+#include "TestProcessor.h"
+
+class Sub808MultirateTests : public juce::UnitTest
+{
+public:
+    Sub808MultirateTests() : juce::UnitTest ("Multirate", "Sub808") {}
+
+    void runTest() override
+    {
+        beginTest ("Latency follows the interpolator's group delay");
+
+        expectEquals (latencyAt (48000.0,  true,  false), 0);
+        expectEquals (latencyAt (96000.0,  false, false), 0);
+        expectEquals (latencyAt (96000.0,  true,  false), 15);
+        expectEquals (latencyAt (192000.0, true,  false), 31);
+
+        beginTest ("Kit mode runs at the host rate, so reports none");
+
+        expectEquals (latencyAt (96000.0, true, true), 0);
+    }
+
+private:
+    static int latencyAt (double sampleRate, bool multirate, bool kitMode)
+    {
+        Sub808TestProcessor p;
+        p.setParameter ("multirate", multirate ? 1.0f : 0.0f);
+        p.setParameter ("kitMode",   kitMode   ? 1.0f : 0.0f);
+        p.prepare (sampleRate, 512);
+        return p.processor.getLatencySamples();
+    }
+};
+
+static Sub808MultirateTests multirateTests;
+
+//==============================================================================
+class Sub808MultirateBenchmark : public juce::UnitTest
+{
+public:
+    Sub808MultirateBenchmark() : juce::UnitTest ("Multirate benchmark", "Sub808 Benchmarks") {}
+
+    void runTest() override
+    {
+        for (double sampleRate : { 96000.0, 192000.0 })
+        {
+            beginTest (juce::String (sampleRate / 1000.0, 0) + " kHz, full unison stack");
+
+            const double off = secondsPerSample (sampleRate, false);
+            const double on  = secondsPerSample (sampleRate, true);
+
+            logMessage ("multirate off: " + Sub808Bench::nanoseconds (off) + " per sample");
+            logMessage ("multirate on:  " + Sub808Bench::nanoseconds (on) + " per sample ("
+                          + juce::String (off / on, 2) + "x)");
+        }
+    }
+
+private:
+    static constexpr int blockSize = 512;
+
+    static double secondsPerSample (double sampleRate, bool multirate)
+    {
+        Sub808TestProcessor p;
+        p.setParameter ("multirate",    multirate ? 1.0f : 0.0f);
+        p.setParameter ("unisonVoices", 8.0f);
+        p.setParameter ("subOctave",    0.5f);
+        p.setParameter ("octaveUp",     0.5f);
+        p.setParameter ("sustain",      1.0f);
+        p.prepare (sampleRate, blockSize);
+
+        // One long held note
+        p.midi.addEvent (juce::MidiMessage::noteOn (1, 36, (juce::uint8) 100), 0);
+        p.process (blockSize);
+
+        return Sub808Bench::secondsPerCall ([&] { p.process (blockSize); }, 400) / blockSize;
+    }
+};
+
+static Sub808MultirateBenchmark multirateBenchmark;
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    TestProcessor.h
+    Drives a Sub808AudioProcessor directly, the way a host would.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+struct Sub808TestProcessor
+{
+    Sub808AudioProcessor processor;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+
+    void prepare (double sampleRate, int maxBlockSize)
+    {
+        processor.setRateAndBufferSizeDetails (sampleRate, maxBlockSize);
+        processor.prepareToPlay (sampleRate, maxBlockSize);
+
+        buffer.setSize (juce::jmax (processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels()),
+                        maxBlockSize);
+    }
+
+    /** Sets a parameter from its real (not normalised) value. */
+    void setParameter (const juce::String& id, float value)
+    {
+        auto* param = processor.apvts.getParameter (id);
+        jassert (param != nullptr);
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    /** Renders numSamples (up to the prepared block size) with whatever has
+        been added to midi, then clears it. */
+    void process (int numSamples)
+    {
+        juce::AudioBuffer<float> block (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
+        block.clear();
+        processor.processBlock (block, midi);
+        midi.clear();
+    }
+};